@@ -2,6 +2,9 @@
 #define PROJ2DA_DATA_H
 
 #include "Graph.h"
+#include "MetricClosure.h"
+#include "ShortestPaths.h"
+#include <memory>
 #include <string>
 #include <map>
 #include <unordered_set>
@@ -12,48 +15,76 @@ public:
     Data() = default;
     void readNodes(std::string nodeFilePath, int numberOfNodes);
     void readEdges(bool realWorldGraphs, std::string edgesFilePath);
+    void readEdgesParallel(bool realWorldGraphs, std::string edgesFilePath, unsigned threads);
     void parseTOY(bool tourismCSV, std::string edgesFilePath);
-    Graph getNetwork();
+    bool saveSnapshot(const std::string& snapshotPath, const std::vector<std::string>& sources, int numberOfNodes,
+                      bool realWorldGraphs) const;
+    bool loadSnapshot(const std::string& snapshotPath, const std::vector<std::string>& sources, int numberOfNodes,
+                      bool realWorldGraphs);
+    void loadGraph(const std::string& nodeFilePath, int numberOfNodes, bool realWorldGraphs, const std::string& edgesFilePath);
+    void loadTOY(bool tourismCSV, const std::string& edgesFilePath);
+    const Graph& getNetwork() const;
     double getCost();
     bool isTourism();
-    std::vector<Vertex*> getBestTour();
-    std::map<std::string,std::string> getTourismLabels();
+    const std::vector<Vertex*>& getBestTour() const;
+    const std::map<std::string,std::string>& getTourismLabels() const;
 
     void backtrackingTSP();
-    void backtrack(std::vector<Vertex*>& currentTour, double currentCost);
+    void backtrack(std::vector<Vertex*>& currentTour, double currentCost, Workspace& state);
+    void heldKarpTSP();
+    void branchAndBoundTSP();
+    void parallelBacktrackingTSP(unsigned threads);
 
     double calculateTourCost(const std::vector<Vertex*>& tour) const;
-    double haversineDistance(double lat1, double lon1, double lat2, double lon2) const;
-    void resetNodesVisitation();
-    Vertex* findNearestNeighbor(Vertex* v);
+    Vertex* findNearestNeighbor(Vertex* v, const Workspace& state);
     void triangularHeuristicAproximation(const std::string& startNodeId);
-    void dfsMST(Vertex* v, const std::vector<Vertex*>& mst);
-    void createMstGraph(Graph &mstGraph, std::vector<Vertex*>  mst);
-    std::vector<Vertex*> getAproximationTour();
+    const std::vector<Vertex*>& getAproximationTour() const;
     double getAproximationTourCost();
     void clusterApproximationTSP(const std::string& startNodeId);
-    Vertex* findNearestNeighborCluster(Vertex* v, const std::unordered_set<Vertex*>& cluster);
-    std::vector<Vertex*> getClusterTour();
-    std::vector<Vertex *> prim(Graph * g);
+    Vertex* findNearestNeighborCluster(Vertex* v, const Workspace& state);
+    const std::vector<Vertex*>& getClusterTour() const;
+    Workspace prim(const Graph& g, unsigned threads = 1) const;
     double getClusterTourCost();
-    void preorderTraversalMST(Vertex* u);
+    void preorderTraversalMST(Vertex* u, const Workspace& tree);
     void mstApproximationTSP(const std::string& startNodeId);
-    std::vector<Vertex*> getMSTTour();
+    const std::vector<Vertex*>& getMSTTour() const;
     double getMSTTourCost();
+    void geometricNearestNeighbourTSP(const std::string& startNodeId);
+    const std::vector<Vertex*>& getGeometricTour() const;
+    double getGeometricTourCost();
+    void christofidesTSP(const std::string& startNodeId, bool exactMatching);
+    const std::vector<Vertex*>& getChristofidesTour() const;
+    double getChristofidesTourCost();
+    const std::vector<std::pair<std::string, double>>& getChristofidesPhases() const;
 
 
     std::string bfs_farthest_node(const std::string& start);
-    std::unordered_map<std::string, int> dijkstra(const std::string& start);
+    std::vector<double> dijkstra(const std::string& start);
     std::vector<std::string> tsp_real_world1( std::string start);
     void removeVertex(std::string id);
     void removeEdge(std::string id1, std::string id2);
 
     std::vector<std::string> twoOpt(const std::vector<std::string>& tour);
+    double improveTour(std::vector<Vertex*>& tour);
     bool isConnected(const std::string& start);
     std::vector<std::string> tsp_real_world2( std::string start);
+    std::vector<std::string> linKernighanTSP(const std::string& start, double timeLimit);
+    const std::vector<std::pair<double, double>>& getLinKernighanProgress() const;
+    double getLinKernighanTourCost() const;
+
+    bool buildMetricClosure(const std::vector<std::string>& subset, unsigned threads);
+    const MetricClosure& getMetricClosure() const;
+    std::vector<std::string> metricClosureTSP(const std::string& start, unsigned threads);
+    double getMetricClosureTourCost() const;
+    std::vector<std::string> expandMetricClosureTour(const std::vector<std::string>& tour) const;
+
+    const CandidateLists& buildCandidateLists(int k);
 
 
 private:
+        void freezeNetwork();
+        ShortestPaths& shortestPaths() const;
+
         std::vector<Vertex*> bestTour;
         double bestCost;
 
@@ -66,8 +97,23 @@ private:
         std::vector<Vertex*> mst_tour_;
         double mst_tourCost_;
 
+        std::vector<Vertex*> geometric_tour_;
+        double geometric_tourCost_ = 0;
+
+        std::vector<Vertex*> christofides_tour_;
+        double christofides_tourCost_ = 0;
+        std::vector<std::pair<std::string, double>> christofides_phases_;
+
+        std::vector<std::pair<double, double>> lk_progress_;
+        double lk_tourCost_ = 0;
+
+        MetricClosure closure_;
+        double closure_tourCost_ = 0;
+        std::string snapshot_;
+
         bool tourism=false;
         Graph network_;
+        mutable std::unique_ptr<ShortestPaths> paths_;
         std::map<std::string,std::string> tourismLabels;
 
 
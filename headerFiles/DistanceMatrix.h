@@ -0,0 +1,78 @@
+#ifndef PROJ2DA_DISTANCEMATRIX_H
+#define PROJ2DA_DISTANCEMATRIX_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+/**
+ * @brief Allocator returning memory aligned to Alignment bytes (a cache line by default).
+ */
+template <class T, std::size_t Alignment = 64>
+class AlignedAllocator {
+public:
+    typedef T value_type;
+
+    template <class U>
+    struct rebind {
+        typedef AlignedAllocator<U, Alignment> other;
+    };
+
+    AlignedAllocator() = default;
+    template <class U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+    T* allocate(std::size_t n) {
+        std::size_t bytes = (n * sizeof(T) + Alignment - 1) / Alignment * Alignment;
+        void* p = std::aligned_alloc(Alignment, bytes);
+        if (p == nullptr) throw std::bad_alloc();
+        return static_cast<T*>(p);
+    }
+
+    void deallocate(T* p, std::size_t) {
+        std::free(p);
+    }
+
+    template <class U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const { return true; }
+    template <class U>
+    bool operator!=(const AlignedAllocator<U, Alignment>&) const { return false; }
+};
+
+/**
+ * @brief Contiguous N x N matrix of weights with O(1) lookup by vertex id.
+ *
+ * The storage is cache-line aligned and, in the full layout, every row is padded to a whole number of
+ * cache lines. In the triangular layout only the upper triangle (i <= j) is stored, which halves the
+ * memory for symmetric graphs; get(i, j) and get(j, i) then return the same value.
+ */
+class DistanceMatrix {
+public:
+    DistanceMatrix();
+    DistanceMatrix(int n, bool triangular, double fill);
+
+    int size() const { return n; }
+    bool isTriangular() const { return triangular; }
+    bool empty() const { return n == 0; }
+
+    double get(int i, int j) const { return data[index(i, j)]; }
+    void set(int i, int j, double w) { data[index(i, j)] = w; }
+    const double* row(int i) const;
+
+    void clear();
+
+protected:
+    std::size_t index(int i, int j) const {
+        if (!triangular) return (std::size_t) i * stride + j;
+        return i <= j ? rowStart[i] + j : rowStart[j] + i;
+    }
+
+    int n;
+    bool triangular;
+    std::size_t stride;
+    std::vector<std::size_t> rowStart;
+    std::vector<double, AlignedAllocator<double>> data;
+};
+
+#endif //PROJ2DA_DISTANCEMATRIX_H
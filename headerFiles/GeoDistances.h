@@ -0,0 +1,37 @@
+#ifndef PROJ2DA_GEODISTANCES_H
+#define PROJ2DA_GEODISTANCES_H
+
+#include "DistanceMatrix.h"
+#include <vector>
+
+/**
+ * @brief Haversine distances between vertices, from coordinates precomputed once per vertex.
+ *
+ * Every vertex is stored as the point (cos lat cos lon, cos lat sin lon, sin lat) on the unit sphere, one
+ * aligned array per axis. The haversine term of two points is a quarter of their squared straight-line
+ * (chord) distance, so a distance costs three multiply-adds, one square root and one arcsine instead of
+ * the degree conversions, sines, cosines and arctangent of the textbook formula. Data::calculateTourCost
+ * uses it to price tour steps between vertices that have no edge. Vertices without coordinates are at
+ * infinite distance from everything.
+ */
+class GeoDistances {
+public:
+    static constexpr double EARTH_RADIUS = 6371000;
+
+    void reset(int n);
+    void set(int v, double lat, double lon);
+    void clear();
+
+    int size() const { return x.size(); }
+    bool empty() const { return x.empty(); }
+    bool hasCoord(int v) const { return x[v] == x[v]; }
+
+    double distance(int u, int v) const;
+
+protected:
+    std::vector<double, AlignedAllocator<double>> x;
+    std::vector<double, AlignedAllocator<double>> y;
+    std::vector<double, AlignedAllocator<double>> z;
+};
+
+#endif //PROJ2DA_GEODISTANCES_H
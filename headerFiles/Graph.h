@@ -7,7 +7,12 @@
 #include <limits>
 #include <unordered_map>
 #include <algorithm>
+#include <cstdint>
+#include <memory>
 #include "MutablePriorityQueue.h"
+#include "DistanceMatrix.h"
+#include "GeoDistances.h"
+#include "ObjectPool.h"
 
 
 
@@ -21,48 +26,30 @@ public:
     bool hasCoord();
     void setHasCoord(bool hasco);
     void removeOutgoingEdges();
-    void setParent(Vertex* parent);
-    Vertex* getParent() const;
 
-    bool operator<(const Vertex& vertex) const;
-
-    std::string getInfo() const;
+    int getId() const;
+    const std::string& getInfo() const;
     double getLong() const;
     double getLat() const;
-    std::vector<Edge*> getAdj() const;
-    bool isVisited() const;
-    bool isProcessing() const;
-    unsigned int getIndegree() const;
-    double getDist() const;
-    Edge* getPath() const;
-    std::vector<Edge*> getIncoming() const;
+    const std::vector<Edge*>& getAdj() const;
+    const std::vector<Edge*>& getIncoming() const;
 
+    void setId(int id);
     void setInfo(const std::string& info);
-    void setVisited(bool visited);
-    void setProcessing(bool processing);
-    void setIndegree(unsigned int indegree);
-    void setDist(double dist);
-    void setPath(Edge* path);
-
 
-        friend class MutablePriorityQueue<Vertex>;
+    friend class Graph;
 
 protected:
+    int id;
     bool hascoor;
     std::string info;
     double longitude;
     double latitude;
     std::vector<Edge*> adj;
     int type_;
-    bool visited;
-    bool processing;
-    unsigned int indegree;
-    double dist;
-    Edge* path;
     std::vector<Edge*> incoming;
-    Vertex* parent_;
 
-    int queueIndex;
+    ObjectPool<Edge>* edgePool = nullptr;
     void deleteEdge(Edge* edge);
 };
 
@@ -90,40 +77,206 @@ protected:
     double flow;
 };
 
+/**
+ * @brief Frozen compressed-sparse-row copy of a Graph's adjacency lists.
+ *
+ * The outgoing edges of the vertex with id v (see Vertex::getId) are the indices
+ * edgesBegin(v) .. edgesEnd(v) - 1, each with a target id and a weight, in the same order as Vertex::getAdj.
+ * All edges live in three flat arrays, so scanning a vertex's neighbours touches contiguous memory only.
+ */
+class CSRGraph {
+public:
+    int getNumVertex() const { return offsets.empty() ? 0 : (int) offsets.size() - 1; }
+    unsigned getNumEdges() const { return targets.size(); }
+    unsigned edgesBegin(int v) const { return offsets[v]; }
+    unsigned edgesEnd(int v) const { return offsets[v + 1]; }
+    int getTarget(unsigned e) const { return targets[e]; }
+    double getWeight(unsigned e) const { return weights[e]; }
+    double getEdgeWeight(int source, int dest) const;
+
+    friend class Graph;
+
+protected:
+    std::vector<unsigned> offsets;
+    std::vector<int> targets;
+    std::vector<double> weights;
+};
+
+/**
+ * @brief Per-vertex lists of promising neighbours, cheapest edge first, in one contiguous array.
+ *
+ * The list of v (entries begin(v) .. end(v) - 1) holds its k cheapest distinct neighbours and, when built
+ * with quadrants, also the ceil(k / 4) cheapest in each of the four quadrants around v (by longitude and
+ * latitude), so that clustered inputs still get candidates in every direction. Since the extra quadrant
+ * neighbours are never cheaper than the k-th cheapest one, the first min(k, length) entries of a list are
+ * always exactly the k cheapest neighbours. Ties are broken by adjacency order.
+ */
+class CandidateLists {
+public:
+    bool empty() const { return offsets.empty(); }
+    int getK() const { return k; }
+    bool hasQuadrants() const { return quadrants; }
+    unsigned begin(int v) const { return offsets[v]; }
+    unsigned end(int v) const { return offsets[v + 1]; }
+    int getTarget(unsigned c) const { return targets[c]; }
+    double getWeight(unsigned c) const { return weights[c]; }
+    unsigned getMaxLength() const { return maxLength; }
+    double getBuildTime() const { return buildTime; }
+
+    friend class Graph;
+
+protected:
+    int k = 0;
+    bool quadrants = false;
+    unsigned maxLength = 0;
+    double buildTime = 0;
+    std::vector<unsigned> offsets;
+    std::vector<int> targets;
+    std::vector<double> weights;
+};
+
+/**
+ * @brief Reusable buffers for the iterative traversals of Graph (dfsVisit, bfsVisit, dfsIsDAG).
+ *
+ * The visited and processing marks are bitsets indexed by vertex id, so traversals never write to the
+ * vertices: several can run on the same graph at once, each with its own scratch. Keeping one scratch
+ * across calls saves reallocating the stack and queue.
+ */
+class TraversalScratch {
+public:
+    void reset(int n);
+    bool isVisited(int v) const { return visited[v >> 6] >> (v & 63) & 1; }
+    void setVisited(int v) { visited[v >> 6] |= (uint64_t) 1 << (v & 63); }
+    bool isProcessing(int v) const { return processing[v >> 6] >> (v & 63) & 1; }
+    void setProcessing(int v, bool on) {
+        if (on) processing[v >> 6] |= (uint64_t) 1 << (v & 63);
+        else processing[v >> 6] &= ~((uint64_t) 1 << (v & 63));
+    }
+    // Depth-first stack of (vertex id, index of the next edge to look at in its adjacency list).
+    std::vector<std::pair<int, unsigned>>& getStack() { return stack; }
+    std::vector<int>& getQueue() { return queue; }
+
+protected:
+    std::vector<uint64_t> visited;
+    std::vector<uint64_t> processing;
+    std::vector<std::pair<int, unsigned>> stack;
+    std::vector<int> queue;
+};
+
+/**
+ * @brief The per-vertex state of one run of an algorithm, indexed by vertex id.
+ *
+ * Solvers keep what they used to write into the vertices (visited marks, tentative distances, the tree
+ * edge or parent each vertex hangs from) here instead, so the graph is only read while solving and
+ * several runs can share one graph, each with its own workspace.
+ */
+class Workspace {
+public:
+    Workspace() = default;
+    explicit Workspace(int n) { reset(n); }
+    void reset(int n);
+    int size() const { return (int) visited.size(); }
+
+    bool isVisited(int v) const { return visited[v]; }
+    void setVisited(int v, bool on) { visited[v] = on; }
+    double getDist(int v) const { return dist[v]; }
+    void setDist(int v, double d) { dist[v] = d; }
+    Edge* getPath(int v) const { return path[v]; }
+    void setPath(int v, Edge* e) { path[v] = e; }
+    int getParent(int v) const { return parents[v]; }
+    void setParent(int v, int p) { parents[v] = p; }
+    const std::vector<int>& getParents() const { return parents; }
+
+protected:
+    std::vector<char> visited;
+    std::vector<double> dist;
+    std::vector<Edge*> path;
+    std::vector<int> parents;
+};
+
+/**
+ * @brief An edge given by the ids (see Vertex::getId) of its endpoints, as produced by the file loaders.
+ */
+struct EdgeRecord {
+    int source;
+    int dest;
+    double weight;
+};
+
 class Graph {
 public:
+    Graph();
+    ~Graph();
+    Graph(const Graph&) = delete;
+    Graph& operator=(const Graph&) = delete;
+    Graph(Graph&& other) noexcept;
+    Graph& operator=(Graph&& other) noexcept;
+
     Vertex* findVertex(const std::string& in) const;
+    int findVertexIdx(const std::string& in) const;
     bool addVertex(const std::string& in, const double & longitude, const double & latitude, bool f);
     bool removeVertex(const std::string& in);
     bool addEdge(const std::string& source, const std::string& dest, double w);
     bool removeEdge(const std::string& source, const std::string& dest);
     bool addBidirectionalEdge(const std::string& source, const std::string& dest, double w);
+    void addEdges(const std::vector<EdgeRecord>& edges, bool bothWays);
 
 
     int getNumVertex() const;
-    std::vector<Vertex*> getVertexSet() const;
-    std::unordered_map<std::string, Vertex*> getVertexMap() const;
+    Vertex* getVertex(int id) const;
+    const std::vector<Vertex*>& getVertexSet() const;
+    const std::unordered_map<std::string, Vertex*>& getVertexMap() const;
 
     std::vector<std::string> dfs() const;
     std::vector<std::string> dfs(const std::string& source) const;
-    void dfsVisit(Vertex* v, std::vector<std::string>& res) const;
+    void dfsVisit(int v, TraversalScratch& scratch, std::vector<int>& order) const;
     std::vector<std::string> bfs(const std::string& source) const;
+    void bfsVisit(int v, TraversalScratch& scratch, std::vector<int>& order) const;
 
     bool isDAG() const;
-    bool dfsIsDAG(Vertex* v) const;
+    bool dfsIsDAG(int v, TraversalScratch& scratch) const;
     std::vector<std::string> topsort() const;
     double getEdgeWeight(const std::string &source, const std::string &dest) const;
 
+    void freeze();
+    void loadCSR(const unsigned* offsets, const int* targets, const double* weights);
+    bool isFrozen() const;
+    const CSRGraph& getCSR() const;
+
+    void buildDistanceMatrix(bool triangular);
+    void setDistanceMatrix(std::shared_ptr<const DistanceMatrix> matrix);
+    bool hasDistanceMatrix() const;
+    const DistanceMatrix& getDistanceMatrix() const;
+    double getEdgeWeight(int source, int dest) const {
+        return distMatrix ? distMatrix->get(source, dest) : csr.getEdgeWeight(source, dest);
+    }
+
+    void buildCandidates(int k, bool quadrants);
+    bool hasCandidates() const;
+    const CandidateLists& getCandidates() const;
+
+    const GeoDistances& getGeoDistances() const;
 
 
 protected:
     std::vector<Vertex*> vertexSet;
     std::unordered_map<std::string, Vertex*> vertexMap;
+    CSRGraph csr;
+    bool frozen = false;
 
-    double** distMatrix;
+    std::shared_ptr<const DistanceMatrix> distMatrix;
     int** pathMatrix;
+    CandidateLists candidates;
+    GeoDistances geo;
+
+    void updateDistanceMatrix();
+    void updateGeoDistances();
+
+    // Behind pointers so that their addresses, which every Vertex keeps, survive moving the graph.
+    std::unique_ptr<ObjectPool<Vertex>> vertexPool;
+    std::unique_ptr<ObjectPool<Edge>> edgePool;
+    void destroyVertices();
 
-    int findVertexIdx(const std::string& in) const;
     void deleteMatrix(int** m, int n);
     void deleteMatrix(double** m, int n);
 
@@ -0,0 +1,55 @@
+#ifndef PROJ2DA_KDTREE_H
+#define PROJ2DA_KDTREE_H
+
+#include "Graph.h"
+#include <vector>
+
+/**
+ * @brief Static 3-d tree over the coordinates of the vertices of a graph, for geometric nearest-neighbour queries.
+ *
+ * Latitude/longitude are mapped to points on the unit sphere, where the straight-line (chord) distance grows
+ * with the great-circle distance, so the nearest points in the tree are exactly the nearest by haversine
+ * distance. Distances are reported in metres, on the same Earth radius as GeoDistances.
+ *
+ * The tree is stored implicitly: the subtree of the index range [lo, hi) has its splitting point at
+ * (lo + hi) / 2. Every subtree counts the points still included in it, so vertices excluded with
+ * markVisited are skipped in O(1) per empty subtree and a nearest-neighbour tour costs O(N log N) on
+ * typical inputs instead of O(N^2). Only vertices with coordinates (Vertex::hasCoord) are in the tree.
+ */
+class KdTree {
+public:
+    KdTree() = default;
+    explicit KdTree(const Graph& graph);
+
+    void build(const Graph& graph);
+    int size() const { return points.size(); }
+    bool contains(int v) const { return v >= 0 && v < (int) slot.size() && slot[v] != -1; }
+
+    int nearest(int v) const;
+    std::vector<int> kNearest(int v, int k) const;
+    std::vector<int> radius(int v, double metres) const;
+    double distance(int u, int v) const;
+
+    void markVisited(int v);
+    bool isVisited(int v) const { return excluded[slot[v]]; }
+    void resetVisited();
+
+protected:
+    struct Point {
+        double c[3];
+        int id;
+    };
+
+    static double chordSquared(const Point& a, const Point& b);
+    void buildRange(int lo, int hi);
+    void searchNearest(int lo, int hi, const Point& q, int k, std::vector<std::pair<double, int>>& best) const;
+    void searchRadius(int lo, int hi, const Point& q, double limit, std::vector<std::pair<double, int>>& found) const;
+
+    std::vector<Point> points;
+    std::vector<unsigned char> axis;
+    std::vector<int> alive;
+    std::vector<bool> excluded;
+    std::vector<int> slot;
+};
+
+#endif //PROJ2DA_KDTREE_H
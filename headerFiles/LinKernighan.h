@@ -0,0 +1,48 @@
+#ifndef PROJ2DA_LINKERNIGHAN_H
+#define PROJ2DA_LINKERNIGHAN_H
+
+#include "LocalSearch.h"
+#include <random>
+#include <utility>
+
+/**
+ * @brief Chained Lin-Kernighan: variable-depth moves plus double-bridge kicks.
+ *
+ * A Lin-Kernighan move is a chain of 2-opt moves: edge (t1, t2) is broken, t2 is joined to a neighbour t3,
+ * the tour edge (t3, t4) that makes the result a tour again is broken and the chain continues from t4 for as
+ * long as the partial gain stays positive. The chain is then cut back to its most profitable prefix.
+ * Or-opt moves from LocalSearch are applied as well.
+ * Once no move helps, a random double-bridge kick (swap of two short consecutive segments, which no chain
+ * of 2-opt moves can undo directly) is applied and the tour re-optimised around it; the result is kept only
+ * if it is cheaper, and otherwise undone by replaying the applied moves backwards. Kicks continue until the
+ * time budget runs out.
+ */
+class LinKernighan : public LocalSearch {
+public:
+    LinKernighan(const Graph& graph, int neighbours);
+
+    double solve(std::vector<int>& tour, double timeLimit);
+    const std::vector<std::pair<double, double>>& getProgress() const;
+
+protected:
+    bool improve(int a) override;
+    bool improveLK(int t1);
+    bool extendChain(int t1, int t2, double gain);
+    void undoMoves(size_t keep);
+    double doubleBridge();
+    void swapSegments(int p, int l1, int l2);
+
+    struct Move {
+        int t1, t2, t3, t4;
+        // Number of logged reversals before the move, see undoMoves.
+        size_t logged;
+    };
+
+    std::vector<Move> moves;
+    std::mt19937 random;
+    int kickPosition = 0;
+    std::pair<int, int> kickLengths;
+    std::vector<std::pair<double, double>> progress;
+};
+
+#endif //PROJ2DA_LINKERNIGHAN_H
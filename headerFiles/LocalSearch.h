@@ -0,0 +1,67 @@
+#ifndef PROJ2DA_LOCALSEARCH_H
+#define PROJ2DA_LOCALSEARCH_H
+
+#include "Graph.h"
+#include <vector>
+
+/**
+ * @brief Tour improvement by 2-opt, Or-opt and reversed Or-opt (3-opt segment insertion) moves.
+ *
+ * Tours are vectors of vertex ids (Vertex::getId) that start and end at the same vertex.
+ * Every move is evaluated from the four or six edges it changes, and only the k cheapest neighbours of
+ * a vertex are tried as new endpoints. The weights of those candidate edges are cached next to the
+ * neighbour lists; the other edges are looked up with Graph::getEdgeWeight, so a move costs O(1) to
+ * evaluate with a dense weight matrix and O(D) on sparse graphs, where D is the maximum degree.
+ * Vertices whose surroundings did not change
+ * since they last failed to improve are skipped (don't-look bits).
+ * The graph must be frozen; missing edges count as infinitely long, so moves never introduce them.
+ */
+class LocalSearch {
+public:
+    LocalSearch(const Graph& graph, int neighbours);
+    virtual ~LocalSearch() = default;
+
+    void setMoves(bool twoOpt, bool orOpt);
+    double optimize(std::vector<int>& tour);
+
+protected:
+    static constexpr double IMPROVEMENT_EPS = 1e-7;
+
+    double dist(int a, int b) const { return graph.getEdgeWeight(a, b); }
+    int next(int v) const { return order[pos[v] + 1 == n ? 0 : pos[v] + 1]; }
+    int prev(int v) const { return order[pos[v] == 0 ? n - 1 : pos[v] - 1]; }
+
+    void buildNeighbours();
+    void loadTour(const std::vector<int>& tour);
+    double storeTour(int start, std::vector<int>& tour) const;
+    double tourCost() const;
+    void activate(int v);
+    double runQueue();
+    virtual bool improve(int a);
+    bool improveTwoOpt(int a);
+    bool improveOrOpt(int a);
+    bool tryInsert(int s1, int s2, double removeGain);
+    void move2opt(int a, int b, int c);
+    void reversePath(int from, int to);
+    void reverseSpan(int i, int length);
+
+    const Graph& graph;
+    int n;
+    int k;
+    bool useTwoOpt;
+    bool useOrOpt;
+    std::vector<int> neighbours;
+    // Weight of the edge from each vertex to each of its neighbours, at the same index as in neighbours.
+    std::vector<double> neighbourWeights;
+    std::vector<int> order;
+    std::vector<int> pos;
+    std::vector<bool> active;
+    std::vector<int> queue;
+    // Total gain of the moves applied by the current runQueue call.
+    double gained = 0;
+    // When logging, every reversal applied to order, as (first position, length), so it can be replayed backwards.
+    bool logReversals = false;
+    std::vector<std::pair<int, int>> reversals;
+};
+
+#endif //PROJ2DA_LOCALSEARCH_H
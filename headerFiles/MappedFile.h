@@ -0,0 +1,32 @@
+#ifndef PROJ2DA_MAPPEDFILE_H
+#define PROJ2DA_MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief Read-only view of a whole file, memory-mapped where the platform supports it.
+ *
+ * The contents are available as the character range [begin(), end()) for as long as the object lives,
+ * without being copied into user-space buffers. On platforms without mmap the file is read into memory.
+ */
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* begin() const { return data; }
+    const char* end() const { return data + length; }
+    std::size_t size() const { return length; }
+
+protected:
+    const char* data;
+    std::size_t length;
+    bool mapped;
+    std::string buffer;
+};
+
+#endif //PROJ2DA_MAPPEDFILE_H
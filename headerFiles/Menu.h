@@ -20,11 +20,20 @@ public:
     void drawTop();
     void drawBottom();
     void drawBacktracking(/*std::string vertex_id*/); //diz no enunciado que é sempre com o vertex 0
+    void drawHeldKarp();
+    void drawBranchAndBound();
+    void drawParallelBacktracking();
+    void drawExactResult(const std::string& title, double seconds);
     void drawTriangular(std::string vertex_id);
     void drawCluster(std::string vertex_id);
     void drawApproximationAnalysis(std::string vertex_id);
+    void drawLocalSearch(std::vector<Vertex*> tour);
     void drawTspRealWorld(std::string basicString);
     void drawTspRealWorld2(std::string vertex_id);
+    void drawLinKernighan(std::string vertex_id, double seconds);
+    void drawMetricClosure(std::string vertex_id);
+    void drawCandidateLists(int k);
+    void drawChristofides(std::string vertex_id, bool exactMatching);
 
         void drawRemoveVertexEdge();
     void waitForEnter();
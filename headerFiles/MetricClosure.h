@@ -0,0 +1,42 @@
+#ifndef PROJ2DA_METRICCLOSURE_H
+#define PROJ2DA_METRICCLOSURE_H
+
+#include "Graph.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Shortest-path distances between every pair of a subset of the vertices of a graph.
+ *
+ * Entry (i, j), i != j, is the length of the shortest path in the graph from getVertex(i) to getVertex(j),
+ * so the closure is a complete graph on the subset that satisfies the triangle inequality even when the
+ * graph itself is sparse. Unreachable pairs are infinity, and so is the diagonal, as for a vertex without a
+ * self-loop in Graph::getEdgeWeight. The distances live in one DistanceMatrix, which is never changed once
+ * built and is shared with the graphs made by toGraph; rows are computed by independent Dijkstra runs (see
+ * ShortestPaths) spread over a thread pool.
+ */
+class MetricClosure {
+public:
+    MetricClosure() = default;
+
+    void build(const CSRGraph& graph, const std::vector<int>& vertices, unsigned threads);
+    bool save(const std::string& path, uint64_t key) const;
+    bool load(const std::string& path, uint64_t key, const std::vector<int>& vertices);
+    Graph toGraph(const Graph& graph, int neighbours) const;
+    void clear();
+
+    int size() const { return vertices.size(); }
+    bool empty() const { return vertices.empty(); }
+    int getVertex(int i) const { return vertices[i]; }
+    const std::vector<int>& getVertices() const { return vertices; }
+    double get(int i, int j) const { return dist->get(i, j); }
+    const DistanceMatrix& getMatrix() const { return *dist; }
+
+protected:
+    std::vector<int> vertices;
+    std::shared_ptr<const DistanceMatrix> dist = std::make_shared<const DistanceMatrix>();
+};
+
+#endif //PROJ2DA_METRICCLOSURE_H
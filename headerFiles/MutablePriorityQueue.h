@@ -1,92 +1,351 @@
 #ifndef PROJETO1DA_MUTABLEPRIORITYQUEUE_H
 #define PROJETO1DA_MUTABLEPRIORITYQUEUE_H
 
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
 #include <vector>
 
 /**
- * class T must have: (i) accessible field int queueIndex; (ii) operator< defined.
+ * @brief Addressable d-ary min-heap over the items 0 .. capacity-1 (typically vertex ids).
+ *
+ * Keys are stored inline next to their item, so sifting compares contiguous memory instead of chasing
+ * pointers into the objects, and a wider node (Arity children, four by default) halves the depth of the tree
+ * at the price of a few more comparisons per level. The position of every item is kept in an array, which is
+ * what makes decreaseKey possible.
+ *
+ * Interchangeable with RadixHeap: algorithms take the heap type as a template parameter.
  */
-
-template <class T>
-class MutablePriorityQueue {
-    std::vector<T *> H;
-    void heapifyUp(unsigned i);
-    void heapifyDown(unsigned i);
-    inline void set(unsigned i, T * x);
+template <class Key, unsigned Arity = 4>
+class DAryHeap {
 public:
-    MutablePriorityQueue();
-    void insert(T * x);
-    T * extractMin();
-    void decreaseKey(T * x);
-    bool empty();
+    static_assert(Arity >= 2, "a heap node needs at least two children");
+
+    explicit DAryHeap(std::size_t capacity = 0) : pos(capacity, NOT_IN_HEAP) {}
+
+    bool empty() const { return heap.empty(); }
+    std::size_t size() const { return heap.size(); }
+    bool contains(unsigned item) const { return pos[item] != NOT_IN_HEAP; }
+    unsigned top() const { return heap.front().item; }
+    Key topKey() const { return heap.front().key; }
+
+    /**
+     * @brief Removes every item and makes room for items 0 .. capacity-1.
+     *
+     * @complexity Time Complexity: O(capacity)
+     */
+    void reset(std::size_t capacity) {
+        heap.clear();
+        pos.assign(capacity, NOT_IN_HEAP);
+    }
+
+    /**
+     * @brief Removes every item, keeping the capacity.
+     *
+     * @complexity Time Complexity: O(n), where n is the number of items in the heap.
+     */
+    void clear() {
+        for (const Entry& entry : heap) pos[entry.item] = NOT_IN_HEAP;
+        heap.clear();
+    }
+
+    /**
+     * @brief Inserts an item that is not in the heap.
+     *
+     * @complexity Time Complexity: O(log n)
+     */
+    void push(unsigned item, Key key) {
+        heap.push_back({key, item});
+        siftUp(heap.size() - 1);
+    }
+
+    /**
+     * @brief Lowers the key of an item that is in the heap.
+     *
+     * @complexity Time Complexity: O(log n)
+     */
+    void decreaseKey(unsigned item, Key key) {
+        heap[pos[item]].key = key;
+        siftUp(pos[item]);
+    }
+
+    /**
+     * @brief Inserts an item, or lowers its key if it is already in the heap with a larger one.
+     *
+     * @return True if the heap changed.
+     *
+     * @complexity Time Complexity: O(log n)
+     */
+    bool pushOrDecrease(unsigned item, Key key) {
+        if (!contains(item)) {
+            push(item, key);
+            return true;
+        }
+        if (key < heap[pos[item]].key) {
+            decreaseKey(item, key);
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Removes the item with the smallest key.
+     *
+     * @return The item.
+     *
+     * @complexity Time Complexity: O(Arity log n / log Arity)
+     */
+    unsigned pop() {
+        unsigned item = heap.front().item;
+        pos[item] = NOT_IN_HEAP;
+        Entry last = heap.back();
+        heap.pop_back();
+        if (!heap.empty()) {
+            heap.front() = last;
+            siftDown(0);
+        }
+        return item;
+    }
+
+protected:
+    struct Entry {
+        Key key;
+        unsigned item;
+    };
+
+    static constexpr std::size_t NOT_IN_HEAP = std::numeric_limits<std::size_t>::max();
+
+    void siftUp(std::size_t i) {
+        Entry x = heap[i];
+        while (i > 0) {
+            std::size_t up = (i - 1) / Arity;
+            if (!(x.key < heap[up].key)) break;
+            heap[i] = heap[up];
+            pos[heap[i].item] = i;
+            i = up;
+        }
+        heap[i] = x;
+        pos[x.item] = i;
+    }
+
+    void siftDown(std::size_t i) {
+        Entry x = heap[i];
+        std::size_t n = heap.size();
+        while (true) {
+            std::size_t first = i * Arity + 1;
+            if (first >= n) break;
+            std::size_t last = first + Arity < n ? first + Arity : n;
+            std::size_t best = first;
+            for (std::size_t k = first + 1; k < last; k++) {
+                if (heap[k].key < heap[best].key) best = k;
+            }
+            if (!(heap[best].key < x.key)) break;
+            heap[i] = heap[best];
+            pos[heap[i].item] = i;
+            i = best;
+        }
+        heap[i] = x;
+        pos[x.item] = i;
+    }
+
+    std::vector<Entry> heap;
+    std::vector<std::size_t> pos;
 };
 
-// Index calculations
-#define parent(i) ((i) / 2)
-#define leftChild(i) ((i) * 2)
-
-template <class T>
-MutablePriorityQueue<T>::MutablePriorityQueue() {
-    H.push_back(nullptr);
-}
-
-template <class T>
-bool MutablePriorityQueue<T>::empty() {
-    return H.size() == 1;
-}
-
-template <class T>
-T* MutablePriorityQueue<T>::extractMin() {
-    auto x = H[1];
-    H[1] = H.back();
-    H.pop_back();
-    if(H.size() > 1) heapifyDown(1);
-    x->queueIndex = 0;
-    return x;
-}
-
-template <class T>
-void MutablePriorityQueue<T>::insert(T *x) {
-    H.push_back(x);
-    heapifyUp(H.size()-1);
-}
-
-template <class T>
-void MutablePriorityQueue<T>::decreaseKey(T *x) {
-    heapifyUp(x->queueIndex);
-}
-
-template <class T>
-void MutablePriorityQueue<T>::heapifyUp(unsigned i) {
-    auto x = H[i];
-    while (i > 1 && *x < *H[parent(i)]) {
-        set(i, H[parent(i)]);
-        i = parent(i);
-    }
-    set(i, x);
-}
-
-template <class T>
-void MutablePriorityQueue<T>::heapifyDown(unsigned i) {
-    auto x = H[i];
-    while (true) {
-        unsigned k = leftChild(i);
-        if (k >= H.size())
-            break;
-        if (k+1 < H.size() && *H[k+1] < *H[k])
-            ++k;
-        if ( ! (*H[k] < *x) )
-            break;
-        set(i, H[k]);
-        i = k;
-    }
-    set(i, x);
-}
-
-template <class T>
-void MutablePriorityQueue<T>::set(unsigned i, T * x) {
-    H[i] = x;
-    x->queueIndex = i;
-}
+/**
+ * @brief Addressable monotone radix heap over the items 0 .. capacity-1, for unsigned integer keys.
+ *
+ * Only valid when no key smaller than the last popped one is ever inserted, which holds for Dijkstra with
+ * non-negative integer weights. An entry lives in the bucket numbered by the highest bit in which its key
+ * differs from the last popped key, so pushes and decreaseKey are O(1) and every entry moves down at most
+ * once per bit of the key over its whole life, instead of paying a logarithmic sift on every operation.
+ *
+ * Interchangeable with DAryHeap: algorithms take the heap type as a template parameter.
+ */
+template <class Key>
+class RadixHeap {
+public:
+    static_assert(std::is_unsigned<Key>::value && std::numeric_limits<Key>::digits <= 64, "RadixHeap needs unsigned integer keys of at most 64 bits");
+
+    explicit RadixHeap(std::size_t capacity = 0) : loc(capacity) {}
+
+    bool empty() const { return count == 0; }
+    std::size_t size() const { return count; }
+    bool contains(unsigned item) const { return loc[item].bucket != NOT_IN_HEAP; }
+
+    /**
+     * @brief Removes every item and makes room for items 0 .. capacity-1.
+     *
+     * @complexity Time Complexity: O(capacity)
+     */
+    void reset(std::size_t capacity) {
+        for (auto& bucket : buckets) bucket.clear();
+        loc.assign(capacity, Location());
+        count = 0;
+        last = 0;
+    }
+
+    /**
+     * @brief Removes every item, keeping the capacity, and starts over from key 0.
+     *
+     * @complexity Time Complexity: O(n + B), where n is the number of items in the heap.
+     */
+    void clear() {
+        for (auto& bucket : buckets) {
+            for (const Entry& entry : bucket) loc[entry.item].bucket = NOT_IN_HEAP;
+            bucket.clear();
+        }
+        count = 0;
+        last = 0;
+    }
+
+    /**
+     * @brief Inserts an item that is not in the heap. The key must not be below the last popped key.
+     *
+     * @complexity Time Complexity: O(1)
+     */
+    void push(unsigned item, Key key) {
+        place(item, key);
+        count++;
+    }
+
+    /**
+     * @brief Lowers the key of an item that is in the heap. The key must not be below the last popped key.
+     *
+     * @complexity Time Complexity: O(1)
+     */
+    void decreaseKey(unsigned item, Key key) {
+        unlink(item);
+        place(item, key);
+    }
+
+    /**
+     * @brief Inserts an item, or lowers its key if it is already in the heap with a larger one.
+     *
+     * @return True if the heap changed.
+     *
+     * @complexity Time Complexity: O(1)
+     */
+    bool pushOrDecrease(unsigned item, Key key) {
+        if (!contains(item)) {
+            push(item, key);
+            return true;
+        }
+        const Location& l = loc[item];
+        if (key < buckets[l.bucket][l.index].key) {
+            decreaseKey(item, key);
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Gets the smallest key, moving it to bucket 0 first.
+     *
+     * @complexity Time Complexity: amortized O(B), where B is the number of bits of Key.
+     */
+    Key topKey() {
+        refill();
+        return last;
+    }
+
+    /**
+     * @brief Gets the item with the smallest key.
+     *
+     * @complexity Time Complexity: amortized O(B), where B is the number of bits of Key.
+     */
+    unsigned top() {
+        refill();
+        return buckets[0].back().item;
+    }
+
+    /**
+     * @brief Removes the item with the smallest key.
+     *
+     * @return The item.
+     *
+     * @complexity Time Complexity: amortized O(B), where B is the number of bits of Key.
+     */
+    unsigned pop() {
+        refill();
+        unsigned item = buckets[0].back().item;
+        buckets[0].pop_back();
+        loc[item].bucket = NOT_IN_HEAP;
+        count--;
+        return item;
+    }
+
+protected:
+    static constexpr unsigned BITS = std::numeric_limits<Key>::digits;
+    static constexpr unsigned NOT_IN_HEAP = BITS + 1;
+
+    struct Entry {
+        Key key;
+        unsigned item;
+    };
+
+    struct Location {
+        unsigned bucket = NOT_IN_HEAP;
+        unsigned index = 0;
+    };
+
+    /**
+     * @brief Gets the bucket of a key: 0 if it equals the last popped key, else 1 + the highest differing bit.
+     */
+    unsigned bucketOf(Key key) const {
+        unsigned long long diff = key ^ last;
+#if defined(__GNUC__) || defined(__clang__)
+        return diff == 0 ? 0 : 64 - __builtin_clzll(diff);
+#else
+        unsigned b = 0;
+        while (diff != 0) {
+            diff >>= 1;
+            b++;
+        }
+        return b;
+#endif
+    }
+
+    void place(unsigned item, Key key) {
+        unsigned b = bucketOf(key);
+        loc[item] = {b, static_cast<unsigned>(buckets[b].size())};
+        buckets[b].push_back({key, item});
+    }
+
+    void unlink(unsigned item) {
+        Location l = loc[item];
+        auto& bucket = buckets[l.bucket];
+        bucket[l.index] = bucket.back();
+        loc[bucket[l.index].item].index = l.index;
+        bucket.pop_back();
+    }
+
+    /**
+     * @brief Makes bucket 0 non-empty by redistributing the first non-empty bucket around its minimum.
+     */
+    void refill() {
+        if (!buckets[0].empty()) return;
+        unsigned b = 1;
+        while (buckets[b].empty()) b++;
+        Key smallest = buckets[b].front().key;
+        for (const Entry& entry : buckets[b]) {
+            if (entry.key < smallest) smallest = entry.key;
+        }
+        last = smallest;
+        std::vector<Entry> moving;
+        moving.swap(buckets[b]);
+        for (const Entry& entry : moving) {
+            place(entry.item, entry.key);
+        }
+        moving.clear();
+        moving.swap(buckets[b]);
+    }
+
+    std::vector<Entry> buckets[BITS + 1];
+    std::vector<Location> loc;
+    std::size_t count = 0;
+    Key last = 0;
+};
 
 #endif //PROJETO1DA_MUTABLEPRIORITYQUEUE_H
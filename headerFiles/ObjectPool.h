@@ -0,0 +1,76 @@
+#ifndef PROJ2DA_OBJECTPOOL_H
+#define PROJ2DA_OBJECTPOOL_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Pool allocator for objects of one type.
+ *
+ * Objects are carved out of blocks of BlockSize slots by bumping a pointer, so creating one costs no call
+ * to malloc. Destroyed objects leave their slot on a free list that the next create reuses. All blocks are
+ * released at once when the pool is destroyed; the destructors of objects still alive are NOT run, so the
+ * owner must destroy those that need it (trivially destructible objects can simply be abandoned).
+ */
+template <class T, std::size_t BlockSize = 4096>
+class ObjectPool {
+public:
+    ObjectPool() = default;
+
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    /**
+     * @brief Constructs an object in a free slot.
+     *
+     * @param args The constructor arguments.
+     * @return T* The new object.
+     *
+     * @complexity Time Complexity: O(1) amortized.
+     */
+    template <class... Args>
+    T* create(Args&&... args) {
+        Slot* slot;
+        if (freeList != nullptr) {
+            slot = freeList;
+            freeList = freeList->next;
+        }
+        else {
+            if (used == BlockSize) {
+                blocks.emplace_back(new Slot[BlockSize]);
+                used = 0;
+            }
+            slot = &blocks.back()[used++];
+        }
+        return new (slot->storage) T(std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Destroys an object created by this pool and makes its slot available again.
+     *
+     * @param object The object.
+     *
+     * @complexity Time Complexity: O(1)
+     */
+    void destroy(T* object) {
+        object->~T();
+        Slot* slot = reinterpret_cast<Slot*>(object);
+        slot->next = freeList;
+        freeList = slot;
+    }
+
+protected:
+    union Slot {
+        Slot* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    std::vector<std::unique_ptr<Slot[]>> blocks;
+    std::size_t used = BlockSize;
+    Slot* freeList = nullptr;
+};
+
+#endif //PROJ2DA_OBJECTPOOL_H
@@ -0,0 +1,66 @@
+#ifndef PROJ2DA_PERFECTMATCHING_H
+#define PROJ2DA_PERFECTMATCHING_H
+
+#include "DistanceMatrix.h"
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+/**
+ * @brief Minimum-weight perfect matching on a complete graph with an even number of vertices.
+ *
+ * The weights are a symmetric K x K DistanceMatrix (vertices 0 .. K-1); infinite weights are allowed and
+ * only used when there is no other way to match. A matching is returned as the mate of every vertex.
+ *
+ * greedy() matches the cheapest pair of unmatched vertices first. blossom() is exact: Edmonds' weighted
+ * blossom algorithm with dual variables, in O(K^3), run as a maximum-weight matching on integer weights
+ * (2^41 - w), scaled so that the largest finite weight is 2^40; on a complete graph every maximum-weight
+ * matching of positive weights is perfect, so it is the cheapest perfect matching up to that rounding.
+ */
+class PerfectMatching {
+public:
+    explicit PerfectMatching(const DistanceMatrix& weights);
+
+    std::vector<int> greedy() const;
+    std::vector<int> blossom();
+    double cost(const std::vector<int>& mate) const;
+
+protected:
+    struct BlossomEdge {
+        int u;
+        int v;
+        int64_t w;
+    };
+
+    const DistanceMatrix& weights;
+
+    // State of the blossom algorithm, 1-based: vertices 1 .. n, blossoms n + 1 .. nx.
+    int n = 0;
+    int nx = 0;
+    int stride = 0;
+    int lcaStamp = 0;
+    std::vector<BlossomEdge> g;
+    std::vector<int64_t> lab;
+    std::vector<int> match, slack, st, pa, flowerFrom, S, vis;
+    std::vector<std::vector<int>> flower;
+    std::deque<int> q;
+
+    BlossomEdge& edge(int u, int v) { return g[(size_t) u * stride + v]; }
+    int& from(int b, int x) { return flowerFrom[(size_t) b * stride + x]; }
+    int64_t slackOf(const BlossomEdge& e) const { return lab[e.u] + lab[e.v] - e.w * 2; }
+
+    void updateSlack(int u, int x);
+    void setSlack(int x);
+    void push(int x);
+    void setSt(int x, int b);
+    int getPr(int b, int xr);
+    void setMatch(int u, int v);
+    void augment(int u, int v);
+    int getLca(int u, int v);
+    void addBlossom(int u, int lca, int v);
+    void expandBlossom(int b);
+    bool onFoundEdge(const BlossomEdge& e);
+    bool augmentOnce();
+};
+
+#endif //PROJ2DA_PERFECTMATCHING_H
@@ -0,0 +1,56 @@
+#ifndef PROJ2DA_SHORTESTPATHS_H
+#define PROJ2DA_SHORTESTPATHS_H
+
+#include "Graph.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Dijkstra's algorithm over the frozen graph, with a workspace that is reused between queries.
+ *
+ * Distances are doubles and vertices are ids (Vertex::getId). A query may start from several sources at
+ * once (every source at distance 0, as if joined to a virtual super-source) and may stop as soon as all
+ * vertices of a target set are settled. Per-vertex state is only valid when its stamp matches the current
+ * query, so starting a new query costs O(1) instead of resetting V entries, and nothing is reallocated
+ * once the workspace has been sized.
+ * When every weight is a non-negative integer and no path can outgrow the 53 bits a double holds exactly,
+ * the queries run on a RadixHeap of integer distances instead of a DAryHeap; the results are the same.
+ * The graph must stay frozen and unchanged while the workspace is in use.
+ */
+class ShortestPaths {
+public:
+    explicit ShortestPaths(const CSRGraph& graph);
+
+    void run(int source);
+    void run(const std::vector<int>& sources, const std::vector<int>& targets = {});
+
+    bool isReached(int v) const { return stamp[v] == query; }
+    bool isSettled(int v) const { return isReached(v) && settled[v]; }
+    double getDist(int v) const;
+    int getParent(int v) const;
+    int getOrigin(int v) const;
+    std::vector<int> getPath(int target) const;
+    const std::vector<int>& getSettledOrder() const { return order; }
+
+    bool hasIntegralWeights() const { return integral; }
+
+protected:
+    template <class Key, class Heap>
+    void search(Heap& queue, const std::vector<int>& sources, size_t remaining);
+    void touch(int v);
+
+    const CSRGraph& graph;
+    unsigned query;
+    std::vector<unsigned> stamp;
+    std::vector<unsigned> targetStamp;
+    std::vector<double> dist;
+    std::vector<int> parent;
+    std::vector<int> origin;
+    std::vector<bool> settled;
+    std::vector<int> order;
+    bool integral;
+    DAryHeap<double> heap;
+    RadixHeap<uint64_t> radix;
+};
+
+#endif //PROJ2DA_SHORTESTPATHS_H
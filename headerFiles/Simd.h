@@ -0,0 +1,25 @@
+#ifndef PROJ2DA_SIMD_H
+#define PROJ2DA_SIMD_H
+
+// On x86 with GCC or Clang the AVX2 kernels are compiled with per-function target attributes, so the rest
+// of the program needs no special flags; whether they run is decided at run time (see Simd).
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define PROJ2DA_HAS_AVX2 1
+#endif
+
+/**
+ * @brief Run-time CPU feature checks and small kernels shared by the vectorized code paths.
+ *
+ * Kernels guarded by PROJ2DA_HAS_AVX2 must only be called when the matching check returns true; each
+ * one has a scalar fallback that gives the same results.
+ */
+class Simd {
+public:
+    static bool hasAvx2();
+    static bool hasAvx2Fma();
+
+    static int argMin(const double* values, int n);
+};
+
+#endif //PROJ2DA_SIMD_H
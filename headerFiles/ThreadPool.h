@@ -0,0 +1,59 @@
+#ifndef PROJ2DA_THREADPOOL_H
+#define PROJ2DA_THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Fixed-size pool of worker threads with work stealing.
+ *
+ * Every worker owns a deque of tasks. A worker takes its newest task first (depth-first, cache friendly)
+ * and, when its deque is empty, steals the oldest task of another worker. Tasks submitted from inside a
+ * worker go to that worker's deque; tasks submitted from outside are spread round-robin.
+ */
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned threads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(std::function<void()> task);
+    void wait();
+
+    unsigned size() const { return workers.size(); }
+    int currentWorker() const;
+
+    static unsigned defaultThreads();
+
+protected:
+    struct Worker {
+        std::mutex lock;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    void run(unsigned index);
+    bool take(unsigned index, std::function<void()>& task);
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+
+    std::mutex stateLock;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    std::atomic<size_t> queued{0};
+    std::atomic<size_t> pending{0};
+    std::atomic<unsigned> nextWorker{0};
+    bool stopping = false;
+    std::exception_ptr error;
+};
+
+#endif //PROJ2DA_THREADPOOL_H
@@ -2,6 +2,14 @@
 // Created by antero on 25-04-2024.
 //
 #include "../headerFiles/Data.h"
+#include "../headerFiles/LocalSearch.h"
+#include "../headerFiles/LinKernighan.h"
+#include "../headerFiles/ThreadPool.h"
+#include "../headerFiles/MappedFile.h"
+#include "../headerFiles/ShortestPaths.h"
+#include "../headerFiles/KdTree.h"
+#include "../headerFiles/PerfectMatching.h"
+#include "../headerFiles/SpanningTree.h"
 #include <fstream>
 #include <cmath>
 #include <sstream>
@@ -13,90 +21,324 @@
 #include <stack>
 #include <climits>
 #include <list>
+#include <atomic>
+#include <mutex>
+#include <cstdint>
+#include <cstring>
+#include <charconv>
+#include <string_view>
+#include <filesystem>
+#include <cstdio>
+#include <chrono>
 
 using namespace std;
 
 /**
- * @brief Reads node data from a file and adds vertices to the network.
+ * @brief Splits the line [p, lineEnd) at commas, without copying.
  *
- * @param nodeFilePath Path to the file containing node data.
- * @param numberOfNodes Number of nodes to read, or -1 to read all nodes.
- * @throws ios_base::failure if the file cannot be opened.
+ * A trailing carriage return (Windows line endings) is not part of the last field.
  *
- * @complexity O(N) where N is the number of nodes being read.
+ * @param p Start of the line.
+ * @param lineEnd End of the line (the newline or the end of the file).
+ * @param fields Output: up to count fields.
+ * @param count Maximum number of fields; the last one takes the rest of the line.
+ * @return size_t The number of fields found.
+ *
+ * @complexity O(L) where L is the length of the line.
  */
-void Data::readNodes(string nodeFilePath, int numberOfNodes) {
-    ifstream nodesFile(nodeFilePath);
-    if(nodesFile.fail()){
-        ostringstream error_message;
-        error_message << "Could not open file \"" << nodeFilePath << '"';
-        throw ios_base::failure(error_message.str());
+static size_t splitFields(const char* p, const char* lineEnd, string_view* fields, size_t count) {
+    if (lineEnd > p && lineEnd[-1] == '\r') {
+        lineEnd--;
     }
+    if (p == lineEnd) {
+        return 0;
+    }
+    size_t found = 0;
+    while (found + 1 < count) {
+        const char* comma = static_cast<const char*>(memchr(p, ',', lineEnd - p));
+        if (comma == nullptr) {
+            break;
+        }
+        fields[found++] = string_view(p, comma - p);
+        p = comma + 1;
+    }
+    fields[found++] = string_view(p, lineEnd - p);
+    return found;
+}
 
-    string id_str, longitude_str, latitude_str;
-
-    getline(nodesFile, id_str);
-    if(numberOfNodes==-1) {
-        while(getline(nodesFile, id_str, ','), getline(nodesFile, longitude_str, ','),
-                getline(nodesFile, latitude_str, '\n')) {
+/**
+ * @brief Parses a decimal number, with optional surrounding spaces, without copying.
+ *
+ * @param field The text.
+ * @param value Output: the number.
+ * @return bool True if the whole field is a number, false otherwise.
+ *
+ * @complexity O(L) where L is the length of the field.
+ */
+static bool parseNumber(string_view field, double& value) {
+    const char* first = field.data();
+    const char* last = first + field.size();
+    while (first < last && (*first == ' ' || *first == '\t')) first++;
+    while (last > first && (last[-1] == ' ' || last[-1] == '\t')) last--;
+    if (first < last && *first == '+') first++;
+    auto result = from_chars(first, last, value);
+    return result.ec == errc() && result.ptr == last;
+}
 
+/**
+ * @brief Gets the end of the line that starts at p.
+ *
+ * @return const char* The newline that ends the line, or end if it is the last line.
+ *
+ * @complexity O(L) where L is the length of the line.
+ */
+static const char* lineEnd(const char* p, const char* end) {
+    const char* newline = static_cast<const char*>(memchr(p, '\n', end - p));
+    return newline == nullptr ? end : newline;
+}
 
-            double latitude = stod(latitude_str);
-            double longitude = stod(longitude_str);
+/**
+ * @brief Throws the error for a line of a data file that cannot be parsed.
+ *
+ * @param filePath The file.
+ * @param line The 1-based line number.
+ * @throws ios_base::failure always.
+ */
+[[noreturn]] static void malformedLine(const string& filePath, size_t line) {
+    ostringstream error_message;
+    error_message << "Malformed line " << line << " in file \"" << filePath << '"';
+    throw ios_base::failure(error_message.str());
+}
 
-            network_.addVertex(id_str, longitude, latitude, true);
+/**
+ * @brief Resolves vertex names read from a file to vertex ids without building strings.
+ *
+ * Names that are plain non-negative integers (as in every dataset of the project) are found in a flat
+ * table indexed by their value; any other name goes through a hash map of views of the vertex names.
+ * The graph must not change while the lookup is in use.
+ */
+class VertexLookup {
+public:
+    explicit VertexLookup(const Graph& graph) {
+        const auto& vertices = graph.getVertexSet();
+        for (auto v : vertices) {
+            const string& name = v->getInfo();
+            size_t number;
+            if (parseIndex(name, number) && number < 4 * vertices.size() + 1024) {
+                if (number >= byNumber.size()) byNumber.resize(number + 1, -1);
+                byNumber[number] = v->getId();
+            }
+            else {
+                byName.emplace(string_view(name), v->getId());
+            }
+        }
+    }
 
+    /**
+     * @brief Finds a vertex by name.
+     *
+     * @return int The vertex id, or -1 if there is no such vertex.
+     *
+     * @complexity O(L) where L is the length of the name.
+     */
+    int find(string_view name) const {
+        size_t number;
+        if (parseIndex(name, number)) {
+            return number < byNumber.size() ? byNumber[number] : -1;
         }
+        auto it = byName.find(name);
+        return it == byName.end() ? -1 : it->second;
     }
-    else {
-        int nr = numberOfNodes;
-        while(nr!=0) {
-            nr--;
-            getline(nodesFile, id_str, ',');
-            getline(nodesFile, longitude_str, ',');
-            getline(nodesFile, latitude_str, '\n');
 
-            double latitude = stod(latitude_str);
-            double longitude = stod(longitude_str);
+private:
+    // Only canonical integers ("0", "17", not "017" or "+17") count, so every name has one entry.
+    static bool parseIndex(string_view name, size_t& number) {
+        if (name.empty() || name.size() > 9 || (name[0] == '0' && name.size() > 1)) return false;
+        auto result = from_chars(name.data(), name.data() + name.size(), number);
+        return result.ec == errc() && result.ptr == name.data() + name.size();
+    }
+
+    vector<int> byNumber;
+    unordered_map<string_view, int> byName;
+};
 
-            network_.addVertex(id_str, longitude, latitude, true);
+/**
+ * @brief Reads node data from a file and adds vertices to the network.
+ *
+ * The file is memory-mapped and parsed in place. The first line is a header and is skipped.
+ *
+ * @param nodeFilePath Path to the file containing node data.
+ * @param numberOfNodes Number of nodes to read, or -1 to read all nodes.
+ * @throws ios_base::failure if the file cannot be opened or a line cannot be parsed.
+ *
+ * @complexity O(N) where N is the number of nodes being read.
+ */
+void Data::readNodes(string nodeFilePath, int numberOfNodes) {
+    MappedFile file(nodeFilePath);
+    const char* p = file.begin();
+    const char* end = file.end();
+
+    p = min(lineEnd(p, end) + 1, end);
+    size_t line = 1;
+    int nr = numberOfNodes;
+    while (p < end && nr != 0) {
+        const char* eol = lineEnd(p, end);
+        line++;
+        string_view fields[3];
+        size_t count = splitFields(p, eol, fields, 3);
+        p = eol + 1;
+        if (count == 0) {
+            continue;
+        }
+
+        double longitude, latitude;
+        if (count != 3 || !parseNumber(fields[1], longitude) || !parseNumber(fields[2], latitude)) {
+            malformedLine(nodeFilePath, line);
         }
+        network_.addVertex(string(fields[0]), longitude, latitude, true);
+        nr--;
     }
 
+    freezeNetwork();
+}
+
+/**
+ * @brief Parses the edge lines in [p, end) of a mapped file.
+ *
+ * Edges whose endpoints are not in the lookup are skipped.
+ *
+ * @param file The mapped file (used to report the line number of errors).
+ * @param p Start of the first line to parse.
+ * @param end End of the last line to parse.
+ * @param lookup Resolves vertex names to ids.
+ * @param edges Output: the parsed edges, appended in file order.
+ * @param filePath The file path, for error messages.
+ * @throws ios_base::failure if a line cannot be parsed.
+ *
+ * @complexity O(S) where S is the size of the range.
+ */
+static void parseEdges(const MappedFile& file, const char* p, const char* end, const VertexLookup& lookup,
+                       vector<EdgeRecord>& edges, const string& filePath) {
+    while (p < end) {
+        const char* eol = lineEnd(p, end);
+        string_view fields[3];
+        size_t count = splitFields(p, eol, fields, 3);
+        if (count != 0) {
+            double weight;
+            if (count != 3 || !parseNumber(fields[2], weight)) {
+                malformedLine(filePath, 1 + std::count(file.begin(), p, '\n'));
+            }
+            int source = lookup.find(fields[0]);
+            int dest = lookup.find(fields[1]);
+            if (source >= 0 && dest >= 0) {
+                edges.push_back({source, dest, weight});
+            }
+        }
+        p = eol + 1;
+    }
 }
 
 /**
  * @brief Reads edge data from a file and adds edges to the network.
  *
+ * The file is memory-mapped and parsed in place; vertex names are resolved without building strings
+ * and all edges are inserted in one pass at the end. Edges whose endpoints are not in the network are
+ * ignored.
+ *
  * @param realWorldGraphs Indicates if the input file has a header line to skip.
  * @param edgesFilePath Path to the file containing edge data.
- * @throws ios_base::failure if the file cannot be opened.
+ * @throws ios_base::failure if the file cannot be opened or a line cannot be parsed.
  *
- * @complexity O(E) where E is the number of edges being read.
+ * @complexity O(V + E) where E is the number of edges being read.
  */
 void Data::readEdges(bool realWorldGraphs, string edgesFilePath) {  //bool to skip the first line, since in the realWorldGraphs there's a 1st line to skip
-    ifstream edgesFile(edgesFilePath);
-    if(edgesFile.fail()){
-        ostringstream error_message;
-        error_message << "Could not open file \"" << edgesFilePath << '"';
-        throw ios_base::failure(error_message.str());
-    }
+    MappedFile file(edgesFilePath);
+    const char* p = file.begin();
+    const char* end = file.end();
 
     tourism = false;
 
-    string c1, c2, c3;
+    if (realWorldGraphs) {
+        p = min(lineEnd(p, end) + 1, end);
+    }
+
+    VertexLookup lookup(network_);
+    vector<EdgeRecord> edges;
+    edges.reserve(file.size() / 16);
+    parseEdges(file, p, end, lookup, edges, edgesFilePath);
 
-    if(realWorldGraphs) {
-        getline(edgesFile,c1);
+    network_.addEdges(edges, true);
+    freezeNetwork();
+}
+
+/**
+ * Files smaller than this are not worth splitting across threads.
+ */
+static const size_t PARALLEL_READ_MIN_BYTES = size_t(1) << 20;
+
+/**
+ * @brief Reads edge data like readEdges, parsing the file on several threads.
+ *
+ * The file is cut into chunks at newline boundaries (a few per thread, so faster threads can steal the
+ * rest), each chunk is parsed into its own edge buffer on a thread pool, and the buffers are then added
+ * to the network in file order in one pass. The result is identical to readEdges.
+ *
+ * @param realWorldGraphs Indicates if the input file has a header line to skip.
+ * @param edgesFilePath Path to the file containing edge data.
+ * @param threads The number of threads to parse with.
+ * @throws ios_base::failure if the file cannot be opened or a line cannot be parsed.
+ *
+ * @complexity O(S / T + V + E) where S is the file size, T the number of threads and E the number of edges.
+ */
+void Data::readEdgesParallel(bool realWorldGraphs, string edgesFilePath, unsigned threads) {
+    MappedFile file(edgesFilePath);
+    if (threads <= 1 || file.size() < PARALLEL_READ_MIN_BYTES) {
+        readEdges(realWorldGraphs, edgesFilePath);
+        return;
     }
-    while(getline(edgesFile, c1, ','), getline(edgesFile, c2, ','),
-            getline(edgesFile, c3, '\n')) {
+    const char* p = file.begin();
+    const char* end = file.end();
 
-        double weight = stod(c3);
+    tourism = false;
 
-        network_.addEdge(c1, c2, weight);
-        network_.addEdge(c2, c1, weight);
+    if (realWorldGraphs) {
+        p = min(lineEnd(p, end) + 1, end);
     }
+
+    const size_t chunks = threads * 4;
+    vector<const char*> bounds = {p};
+    for (size_t i = 1; i < chunks; i++) {
+        const char* cut = max(bounds.back(), p + (end - p) * i / chunks);
+        bounds.push_back(cut == p ? p : min(lineEnd(cut - 1, end) + 1, end));
+    }
+    bounds.push_back(end);
+
+    VertexLookup lookup(network_);
+    vector<vector<EdgeRecord>> parts(chunks);
+    {
+        ThreadPool pool(threads);
+        for (size_t i = 0; i < chunks; i++) {
+            pool.submit([&, i]() {
+                parts[i].reserve((bounds[i + 1] - bounds[i]) / 16);
+                parseEdges(file, bounds[i], bounds[i + 1], lookup, parts[i], edgesFilePath);
+            });
+        }
+        pool.wait();
+    }
+
+    size_t total = 0;
+    for (const auto& part : parts) {
+        total += part.size();
+    }
+    vector<EdgeRecord> edges;
+    edges.reserve(total);
+    for (auto& part : parts) {
+        edges.insert(edges.end(), part.begin(), part.end());
+        vector<EdgeRecord>().swap(part);
+    }
+
+    network_.addEdges(edges, true);
+    freezeNetwork();
 }
 
 
@@ -157,17 +399,400 @@ void Data::parseTOY(bool tourismCSV, string edgesFilePath) {  //bool to store th
         }
         network_.addEdge(destino, origem, weight);
     }
+
+    freezeNetwork();
 }
 
 
 /**
- * @brief Resets the visitation state of all nodes in the network.
+ * Version of the snapshot format; bump it whenever the layout below changes.
+ */
+static const uint32_t SNAPSHOT_VERSION = 2;
+
+/**
+ * @brief Fixed-size header at the start of a snapshot file.
+ *
+ * All numbers are stored in the byte order of the machine that wrote the file (checked through byteOrder).
+ * After the header come the fingerprints of the source files and then, each starting at an 8-byte aligned
+ * offset recorded here:
+ * - names:  uint64 end offset of each vertex name (V), followed by the names' characters;
+ * - coords: double longitude (V), double latitude (V), uint8 has-coordinates flag (V);
+ * - csr:    uint32 offsets (V + 1), int32 targets (E), double weights (E), each section 8-byte aligned;
+ * - labels: uint64 end offset of each tourism id and label (2L), followed by their characters.
+ */
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint32_t tourism;
+    uint32_t numSources;
+    int32_t numberOfNodes;
+    uint32_t realWorldGraphs;
+    uint64_t numVertices;
+    uint64_t numEdges;
+    uint64_t numLabels;
+    uint64_t sourcesOffset;
+    uint64_t namesOffset;
+    uint64_t coordsOffset;
+    uint64_t csrOffset;
+    uint64_t labelsOffset;
+    uint64_t fileSize;
+};
+
+static const char SNAPSHOT_MAGIC[8] = {'P', '2', 'D', 'A', 'S', 'N', 'A', 'P'};
+static const uint32_t SNAPSHOT_BYTE_ORDER = 0x01020304;
+
+/**
+ * @brief Identifies the contents of a source file by its size and modification time.
+ */
+struct SourceFingerprint {
+    uint64_t size;
+    int64_t modified;
+};
+
+/**
+ * @brief Gets the fingerprint of a file.
  *
- * @complexity O(V) where V is the number of vertices in the network.
+ * @param path The file.
+ * @param fingerprint Output: the fingerprint.
+ * @return bool True on success, false if the file cannot be examined.
+ *
+ * @complexity O(1)
+ */
+static bool fingerprint(const string& path, SourceFingerprint& fingerprint) {
+    error_code error;
+    auto size = filesystem::file_size(path, error);
+    if (error) return false;
+    auto modified = filesystem::last_write_time(path, error);
+    if (error) return false;
+    fingerprint.size = size;
+    fingerprint.modified = modified.time_since_epoch().count();
+    return true;
+}
+
+/**
+ * @brief Rounds an offset up to a multiple of 8.
  */
-void Data::resetNodesVisitation() {
-    for(auto vertex : network_.getVertexSet()) {
-        vertex->setVisited(false);
+static uint64_t align8(uint64_t offset) {
+    return (offset + 7) & ~uint64_t(7);
+}
+
+/**
+ * @brief Saves the network and the tourism labels as a binary snapshot.
+ *
+ * The snapshot records the size and modification time of the given source files, so that loadSnapshot
+ * can tell whether it is still up to date, and the options they were read with, so that it only serves
+ * loads with the same options. The file is written under a temporary name and then renamed, so a crash
+ * never leaves a truncated snapshot behind.
+ *
+ * @param snapshotPath The snapshot file to write.
+ * @param sources The files the data was read from.
+ * @param numberOfNodes The number of nodes that was read (see readNodes), -1 for all of them.
+ * @param realWorldGraphs Whether the edge file was read as a real-world graph (see readEdges).
+ * @return bool True if the snapshot was written, false otherwise (e.g. the directory is read-only).
+ *
+ * @complexity O(V + E + L) where L is the number of tourism labels.
+ */
+bool Data::saveSnapshot(const string& snapshotPath, const vector<string>& sources, int numberOfNodes,
+                        bool realWorldGraphs) const {
+    if (!network_.isFrozen()) {
+        return false;
+    }
+    vector<SourceFingerprint> prints(sources.size());
+    for (size_t i = 0; i < sources.size(); i++) {
+        if (!fingerprint(sources[i], prints[i])) return false;
+    }
+
+    const CSRGraph& csr = network_.getCSR();
+    const auto& vertices = network_.getVertexSet();
+    const uint64_t n = vertices.size();
+    const uint64_t e = csr.getNumEdges();
+
+    SnapshotHeader header = {};
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.byteOrder = SNAPSHOT_BYTE_ORDER;
+    header.tourism = tourism;
+    header.numSources = sources.size();
+    header.numberOfNodes = numberOfNodes;
+    header.realWorldGraphs = realWorldGraphs;
+    header.numVertices = n;
+    header.numEdges = e;
+    header.numLabels = tourismLabels.size();
+
+    // Section sizes first, so the header can be written up front.
+    uint64_t offset = align8(sizeof(SnapshotHeader));
+    header.sourcesOffset = offset;
+    for (const auto& source : sources) {
+        offset = align8(offset + sizeof(SourceFingerprint) + sizeof(uint64_t) + source.size());
+    }
+    uint64_t namesBytes = 0;
+    for (auto v : vertices) namesBytes += v->getInfo().size();
+    header.namesOffset = offset;
+    offset = align8(offset + n * sizeof(uint64_t) + namesBytes);
+    header.coordsOffset = offset;
+    offset = align8(offset + n * (2 * sizeof(double) + 1));
+    header.csrOffset = offset;
+    offset = align8(align8(align8(offset + (n + 1) * sizeof(uint32_t)) + e * sizeof(int32_t)) + e * sizeof(double));
+    uint64_t labelsBytes = 0;
+    for (const auto& label : tourismLabels) labelsBytes += label.first.size() + label.second.size();
+    header.labelsOffset = offset;
+    offset = align8(offset + 2 * header.numLabels * sizeof(uint64_t) + labelsBytes);
+    header.fileSize = offset;
+
+    const string temporary = snapshotPath + ".tmp";
+    ofstream out(temporary, ios::binary | ios::trunc);
+    if (out.fail()) {
+        return false;
+    }
+    uint64_t written = 0;
+    auto put = [&](const void* data, uint64_t size) {
+        out.write(static_cast<const char*>(data), size);
+        written += size;
+    };
+    auto pad = [&]() {
+        static const char zeros[8] = {};
+        put(zeros, align8(written) - written);
+    };
+    auto putArray = [&](const auto& values) {
+        put(values.data(), values.size() * sizeof(values[0]));
+        pad();
+    };
+
+    put(&header, sizeof(header));
+    pad();
+    for (size_t i = 0; i < sources.size(); i++) {
+        uint64_t length = sources[i].size();
+        put(&prints[i], sizeof(SourceFingerprint));
+        put(&length, sizeof(length));
+        put(sources[i].data(), length);
+        pad();
+    }
+
+    vector<uint64_t> ends;
+    uint64_t end = 0;
+    for (auto v : vertices) ends.push_back(end += v->getInfo().size());
+    put(ends.data(), ends.size() * sizeof(uint64_t));
+    for (auto v : vertices) put(v->getInfo().data(), v->getInfo().size());
+    pad();
+
+    vector<double> longitudes, latitudes;
+    vector<uint8_t> hasCoord;
+    for (auto v : vertices) {
+        longitudes.push_back(v->getLong());
+        latitudes.push_back(v->getLat());
+        hasCoord.push_back(v->hasCoord());
+    }
+    put(longitudes.data(), n * sizeof(double));
+    put(latitudes.data(), n * sizeof(double));
+    putArray(hasCoord);
+
+    vector<uint32_t> offsets(n + 1);
+    vector<int32_t> targets(e);
+    vector<double> weights(e);
+    for (uint64_t v = 0; v <= n; v++) offsets[v] = v < n ? csr.edgesBegin(v) : e;
+    for (uint64_t i = 0; i < e; i++) {
+        targets[i] = csr.getTarget(i);
+        weights[i] = csr.getWeight(i);
+    }
+    putArray(offsets);
+    putArray(targets);
+    putArray(weights);
+
+    ends.clear();
+    end = 0;
+    for (const auto& label : tourismLabels) {
+        ends.push_back(end += label.first.size());
+        ends.push_back(end += label.second.size());
+    }
+    put(ends.data(), ends.size() * sizeof(uint64_t));
+    for (const auto& label : tourismLabels) {
+        put(label.first.data(), label.first.size());
+        put(label.second.data(), label.second.size());
+    }
+    pad();
+
+    out.close();
+    if (out.fail() || written != header.fileSize) {
+        remove(temporary.c_str());
+        return false;
+    }
+    error_code error;
+    filesystem::rename(temporary, snapshotPath, error);
+    if (error) {
+        remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Loads the network and the tourism labels from a snapshot written by saveSnapshot.
+ *
+ * The file is memory-mapped and its arrays are used in place: vertex names and labels become strings and
+ * the CSR arrays are handed to Graph::loadCSR, with no text parsing at all. Must be called on a Data with
+ * an empty network.
+ *
+ * @param snapshotPath The snapshot file.
+ * @param sources The files the data would otherwise be read from; they must be the same files, unchanged.
+ * @param numberOfNodes The number of nodes to read, -1 for all of them; must match the snapshot.
+ * @param realWorldGraphs Whether the edge file is a real-world graph; must match the snapshot.
+ * @return bool True if the data was loaded, false if the snapshot is missing, out of date, made with other
+ *         options, of another version or damaged (the network is left empty in that case).
+ *
+ * @complexity O(V + E + L) where L is the number of tourism labels.
+ */
+bool Data::loadSnapshot(const string& snapshotPath, const vector<string>& sources, int numberOfNodes,
+                        bool realWorldGraphs) {
+    if (network_.getNumVertex() != 0 || !filesystem::exists(snapshotPath)) {
+        return false;
+    }
+    try {
+        MappedFile file(snapshotPath);
+        const char* base = file.begin();
+        if (file.size() < sizeof(SnapshotHeader)) {
+            return false;
+        }
+        SnapshotHeader header;
+        memcpy(&header, base, sizeof(header));
+        if (memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0 || header.version != SNAPSHOT_VERSION ||
+            header.byteOrder != SNAPSHOT_BYTE_ORDER || header.fileSize != file.size() ||
+            header.numSources != sources.size() || header.numberOfNodes != numberOfNodes ||
+            header.realWorldGraphs != (uint32_t) realWorldGraphs || header.numVertices >= INT_MAX || header.numEdges >= UINT_MAX) {
+            return false;
+        }
+        const uint64_t n = header.numVertices;
+        const uint64_t e = header.numEdges;
+        auto fits = [&](uint64_t offset, uint64_t size) {
+            return offset <= file.size() && size <= file.size() - offset;
+        };
+
+        uint64_t offset = header.sourcesOffset;
+        for (const auto& source : sources) {
+            SourceFingerprint saved, current;
+            uint64_t length;
+            if (!fits(offset, sizeof(saved) + sizeof(length))) return false;
+            memcpy(&saved, base + offset, sizeof(saved));
+            memcpy(&length, base + offset + sizeof(saved), sizeof(length));
+            offset += sizeof(saved) + sizeof(length);
+            if (!fits(offset, length) || string_view(base + offset, length) != source) return false;
+            if (!fingerprint(source, current) || current.size != saved.size || current.modified != saved.modified) {
+                return false;
+            }
+            offset = align8(offset + length);
+        }
+
+        const uint64_t labelEnds = 2 * header.numLabels * sizeof(uint64_t);
+        const uint64_t offsetsBytes = align8((n + 1) * sizeof(uint32_t));
+        const uint64_t targetsBytes = align8(e * sizeof(int32_t));
+        if (!fits(header.namesOffset, n * sizeof(uint64_t)) || !fits(header.coordsOffset, n * (2 * sizeof(double) + 1)) ||
+            !fits(header.csrOffset, offsetsBytes + targetsBytes + e * sizeof(double)) || !fits(header.labelsOffset, labelEnds) ||
+            header.namesOffset % 8 || header.coordsOffset % 8 || header.csrOffset % 8 || header.labelsOffset % 8) {
+            return false;
+        }
+        const uint64_t* nameEnds = reinterpret_cast<const uint64_t*>(base + header.namesOffset);
+        const char* names = base + header.namesOffset + n * sizeof(uint64_t);
+        const double* longitudes = reinterpret_cast<const double*>(base + header.coordsOffset);
+        const double* latitudes = longitudes + n;
+        const uint8_t* hasCoord = reinterpret_cast<const uint8_t*>(latitudes + n);
+        const uint32_t* offsets = reinterpret_cast<const uint32_t*>(base + header.csrOffset);
+        const int32_t* targets = reinterpret_cast<const int32_t*>(base + header.csrOffset + offsetsBytes);
+        const double* weights = reinterpret_cast<const double*>(base + header.csrOffset + offsetsBytes + targetsBytes);
+        const uint64_t* labelBounds = reinterpret_cast<const uint64_t*>(base + header.labelsOffset);
+        const char* labels = base + header.labelsOffset + labelEnds;
+
+        // Everything is checked before the network is touched, so a damaged file leaves it empty.
+        if ((n > 0 && !fits(names - base, nameEnds[n - 1])) || offsets[0] != 0 || offsets[n] != e) {
+            return false;
+        }
+        for (uint64_t i = 0; i < n; i++) {
+            if (offsets[i] > offsets[i + 1] || (i > 0 && nameEnds[i - 1] > nameEnds[i])) return false;
+        }
+        for (uint64_t i = 0; i < e; i++) {
+            if (targets[i] < 0 || (uint64_t) targets[i] >= n) return false;
+        }
+        for (uint64_t i = 0; i < 2 * header.numLabels; i++) {
+            if ((i > 0 && labelBounds[i - 1] > labelBounds[i]) || !fits(labels - base, labelBounds[i])) return false;
+        }
+        // Duplicate names would be merged by addVertex and shift every id after them.
+        unordered_set<string_view> unique;
+        unique.reserve(n);
+        for (uint64_t i = 0; i < n; i++) {
+            uint64_t first = i == 0 ? 0 : nameEnds[i - 1];
+            if (!unique.insert(string_view(names + first, nameEnds[i] - first)).second) return false;
+        }
+
+        for (uint64_t i = 0; i < n; i++) {
+            uint64_t first = i == 0 ? 0 : nameEnds[i - 1];
+            network_.addVertex(string(names + first, nameEnds[i] - first), longitudes[i], latitudes[i], hasCoord[i] != 0);
+        }
+        static_assert(sizeof(unsigned) == sizeof(uint32_t) && sizeof(int) == sizeof(int32_t), "CSR index types");
+        network_.loadCSR(offsets, targets, weights);
+        paths_.reset();
+
+        tourism = header.tourism != 0;
+        tourismLabels.clear();
+        for (uint64_t i = 0; i < header.numLabels; i++) {
+            uint64_t first = i == 0 ? 0 : labelBounds[2 * i - 1];
+            uint64_t middle = labelBounds[2 * i], last = labelBounds[2 * i + 1];
+            tourismLabels.emplace(string(labels + first, middle - first), string(labels + middle, last - middle));
+        }
+        return true;
+    }
+    catch (const ios_base::failure&) {
+        return false;
+    }
+}
+
+/**
+ * @brief Reads a graph from its node and edge files, through a snapshot next to the edge file.
+ *
+ * If edgesFilePath + ".snap" is up to date with both files and was made with the same numberOfNodes and
+ * realWorldGraphs it is loaded instead of the CSV files;
+ * otherwise the CSV files are read and the snapshot is (re)written for the next time. The snapshot then
+ * also keys the on-disk cache of the metric closure (see buildMetricClosure).
+ *
+ * @param nodeFilePath Path to the file containing node data.
+ * @param numberOfNodes Number of nodes to read, or -1 to read all nodes.
+ * @param realWorldGraphs Indicates if the edge file has a header line to skip.
+ * @param edgesFilePath Path to the file containing edge data.
+ * @throws ios_base::failure if the CSV files have to be read and cannot be.
+ *
+ * @complexity O(V + E) either way, without any text parsing when the snapshot is used.
+ */
+void Data::loadGraph(const string& nodeFilePath, int numberOfNodes, bool realWorldGraphs, const string& edgesFilePath) {
+    const string snapshot = edgesFilePath + ".snap";
+    snapshot_ = snapshot;
+    if (loadSnapshot(snapshot, {nodeFilePath, edgesFilePath}, numberOfNodes, realWorldGraphs)) {
+        return;
+    }
+    readNodes(nodeFilePath, numberOfNodes);
+    readEdgesParallel(realWorldGraphs, edgesFilePath, ThreadPool::defaultThreads());
+    if (!saveSnapshot(snapshot, {nodeFilePath, edgesFilePath}, numberOfNodes, realWorldGraphs)) {
+        snapshot_.clear();
+    }
+}
+
+/**
+ * @brief Reads a toy graph, through a snapshot next to its file (see loadGraph).
+ *
+ * The snapshot is keyed on tourismCSV where loadGraph keys it on realWorldGraphs.
+ *
+ * @param tourismCSV Indicates if the input file contains tourism labels.
+ * @param edgesFilePath Path to the file containing edge data.
+ * @throws ios_base::failure if the CSV file has to be read and cannot be.
+ *
+ * @complexity O(V + E) either way, without any text parsing when the snapshot is used.
+ */
+void Data::loadTOY(bool tourismCSV, const string& edgesFilePath) {
+    const string snapshot = edgesFilePath + ".snap";
+    snapshot_ = snapshot;
+    if (loadSnapshot(snapshot, {edgesFilePath}, -1, tourismCSV)) {
+        return;
+    }
+    parseTOY(tourismCSV, edgesFilePath);
+    if (!saveSnapshot(snapshot, {edgesFilePath}, -1, tourismCSV)) {
+        snapshot_.clear();
     }
 }
 
@@ -179,10 +804,34 @@ void Data::resetNodesVisitation() {
  *
  * @complexity O(1)
  */
-Graph Data::getNetwork() {
+const Graph& Data::getNetwork() const {
     return network_;
 }
 
+/**
+ * @brief Freezes the network after a change and drops the Dijkstra workspace sized for the old one.
+ *
+ * @complexity O(V + E), see Graph::freeze
+ */
+void Data::freezeNetwork() {
+    network_.freeze();
+    paths_.reset();
+}
+
+/**
+ * @brief Gets the Dijkstra workspace of the network, building it on first use after a change.
+ *
+ * @return ShortestPaths& The workspace, shared by every shortest-path query on the network.
+ *
+ * @complexity O(V) when the workspace is built, O(1) otherwise.
+ */
+ShortestPaths& Data::shortestPaths() const {
+    if (!paths_) {
+        paths_ = std::make_unique<ShortestPaths>(network_.getCSR());
+    }
+    return *paths_;
+}
+
 /**
  * @brief Returns the map of tourism labels.
  *
@@ -190,7 +839,7 @@ Graph Data::getNetwork() {
  *
  * @complexity O(1)
  */
-map<string, string> Data::getTourismLabels() {
+const map<string, string>& Data::getTourismLabels() const {
     return tourismLabels;
 }
 
@@ -206,15 +855,10 @@ void Data::backtrackingTSP() {
     bestCost = numeric_limits<double>::max();
     vector<Vertex*> currentTour;
     Vertex* v = network_.findVertex("0");
-
-
-    for(auto vertex : network_.getVertexSet()) {
-        vertex->setVisited(false);
-    }
+    Workspace state(network_.getNumVertex());
 
     currentTour.push_back(v);
-    backtrack(currentTour, 0);
-    resetNodesVisitation();
+    backtrack(currentTour, 0, state);
 }
 
 /**
@@ -222,10 +866,11 @@ void Data::backtrackingTSP() {
  *
  * @param currentTour Current tour path.
  * @param currentCost Current cost of the tour.
+ * @param state Marks the vertices on the current tour as visited.
  *
  * @complexity O(N!) where N is the number of nodes.
  */
-void Data::backtrack(vector<Vertex*>& currentTour, double currentCost) {
+void Data::backtrack(vector<Vertex*>& currentTour, double currentCost, Workspace& state) {
     if (currentTour.size() == network_.getVertexSet().size()+1 && currentTour.back() == currentTour.front()) {
         if (currentCost < bestCost) {
             bestTour = currentTour;
@@ -234,14 +879,19 @@ void Data::backtrack(vector<Vertex*>& currentTour, double currentCost) {
         return;
     }
 
-    Vertex* lastVertex = currentTour.back();
-    for (auto edge : lastVertex->getAdj()) {
-        Vertex* neighbor = edge->getDest();
-        if (!neighbor->isVisited()) {
-            currentTour.push_back(neighbor);
-            neighbor->setVisited(true);
-            backtrack(currentTour, currentCost + edge->getWeight());
-            neighbor->setVisited(false);
+    if (currentCost >= bestCost) {
+        return;
+    }
+
+    const CSRGraph& csr = network_.getCSR();
+    int last = currentTour.back()->getId();
+    for (unsigned e = csr.edgesBegin(last); e < csr.edgesEnd(last); e++) {
+        int neighbor = csr.getTarget(e);
+        if (!state.isVisited(neighbor)) {
+            currentTour.push_back(network_.getVertex(neighbor));
+            state.setVisited(neighbor, true);
+            backtrack(currentTour, currentCost + csr.getWeight(e), state);
+            state.setVisited(neighbor, false);
             currentTour.pop_back();
         }
     }
@@ -249,212 +899,899 @@ void Data::backtrack(vector<Vertex*>& currentTour, double currentCost) {
 
 
 /**
- * @brief Calculates the cost of a given tour.
+ * @brief Builds a dense distance table over all vertices, with the start vertex at index 0.
  *
- * @param tour The tour path as a vector of vertices.
- * @return double The total cost of the tour.
+ * @param startVertex The vertex placed at index 0.
+ * @param graph The (frozen) graph.
+ * @param nodes Output: the vertex at each index of the table.
+ * @param dist Output: n x n row-major table of edge weights, infinity where there is no edge (as in
+ *        CSRGraph::getEdgeWeight, also from a vertex to itself unless it has a self-loop).
  *
- * @complexity O(N^2) where N is the number of nodes in the tour.
+ * @complexity O(V^2 + E) where V is the number of vertices and E is the number of edges.
  */
-double Data::calculateTourCost(const vector<Vertex*>& tour) const {
-    double cost = 0;
-    int nodenr=0;
-    for (size_t i = 0; i < tour.size() - 1; ++i) {
-        Vertex* v1 = tour[i];
-        Vertex* v2 = tour[i + 1];
-        bool haveEdge=false;
-        for (Edge* edge : v1->getAdj()) {
-            if (edge->getDest()->getInfo() == v2->getInfo()) {
-                cost += edge->getWeight();
-                nodenr++;
-                haveEdge=true;
-                break;
-            }
-        }
-        if(!haveEdge && v1->hasCoord() && v2->hasCoord()) {
-            cost += haversineDistance(v1->getLat(),v1->getLong(),v2->getLat(),v2->getLong());
-            nodenr++;
-        }
+static void buildDistanceTable(Vertex* startVertex, const Graph& graph,
+                               vector<Vertex*>& nodes, vector<double>& dist) {
+    const CSRGraph& csr = graph.getCSR();
+    const size_t n = csr.getNumVertex();
+    const int start = startVertex->getId();
+
+    // The start vertex moves to index 0, the ones before it shift one place up.
+    vector<size_t> index(n);
+    nodes.resize(n);
+    for (size_t id = 0; id < n; id++) {
+        index[id] = (int) id == start ? 0 : ((int) id < start ? id + 1 : id);
+        nodes[index[id]] = graph.getVertex(id);
     }
-    if(nodenr+1 < aproximation_tour_.size()) {
-        return -1;
+
+    dist.assign(n * n, numeric_limits<double>::infinity());
+    for (size_t id = 0; id < n; id++) {
+        size_t i = index[id];
+        for (unsigned e = csr.edgesBegin(id); e < csr.edgesEnd(id); e++) {
+            size_t j = index[csr.getTarget(e)];
+            dist[i * n + j] = min(dist[i * n + j], csr.getWeight(e));
+        }
     }
-    return cost;
 }
 
 
 /**
- * @brief Returns the best tour cost found by the backtracking algorithm.
+ * Upper bound, in bytes, for the Held-Karp DP table.
+ */
+static const size_t HELD_KARP_MEMORY_LIMIT = size_t(2) << 30;
+
+/**
+ * @brief Fills the Held-Karp table and rebuilds the optimal tour from it.
  *
- * @return double The cost of the best tour.
+ * The table is laid out as dp[mask * m + j]: the cost of the cheapest path that leaves the start,
+ * visits exactly the nodes in mask and ends at node j. Entries for j outside of mask stay at
+ * infinity, so the inner minimisation is a branch-free loop over a contiguous row.
+ * Parents are not stored; they are recovered by re-evaluating the same expression.
  *
- * @complexity O(1)
+ * @param dist Distance table (n x n, row-major), index 0 is the start vertex.
+ * @param n Number of vertices.
+ * @param order Output: tour as indices into the distance table, starting and ending at 0.
+ *
+ * @complexity O(N^2 * 2^N) time and O(N * 2^N) memory.
  */
-double Data::getCost() {
-    return bestCost;
-}
+template <class Cost>
+static void heldKarpSolve(const vector<double>& dist, size_t n, vector<size_t>& order) {
+    const Cost inf = numeric_limits<Cost>::infinity();
+    const size_t m = n - 1;
+    const size_t full = (size_t(1) << m) - 1;
+
+    vector<Cost> toNode(m * m);       // toNode[j * m + k] = d(k+1, j+1)
+    vector<Cost> fromStart(m), toStart(m);
+    for (size_t j = 0; j < m; j++) {
+        fromStart[j] = static_cast<Cost>(dist[j + 1]);
+        toStart[j] = static_cast<Cost>(dist[(j + 1) * n]);
+        for (size_t k = 0; k < m; k++) {
+            toNode[j * m + k] = static_cast<Cost>(dist[(k + 1) * n + j + 1]);
+        }
+    }
 
+    vector<Cost> dp((full + 1) * m, inf);
+    for (size_t j = 0; j < m; j++) {
+        dp[(size_t(1) << j) * m + j] = fromStart[j];
+    }
+    for (size_t mask = 1; mask <= full; mask++) {
+        if ((mask & (mask - 1)) == 0) continue;
+        Cost* row = &dp[mask * m];
+        for (size_t j = 0; j < m; j++) {
+            if (!(mask & (size_t(1) << j))) continue;
+            const Cost* prev = &dp[(mask ^ (size_t(1) << j)) * m];
+            const Cost* in = &toNode[j * m];
+            Cost best = inf;
+            for (size_t k = 0; k < m; k++) {
+                Cost candidate = prev[k] + in[k];
+                best = candidate < best ? candidate : best;
+            }
+            row[j] = best;
+        }
+    }
 
+    order.clear();
+    size_t last = m;
+    Cost best = inf;
+    for (size_t j = 0; j < m; j++) {
+        Cost candidate = dp[full * m + j] + toStart[j];
+        if (candidate < best) {
+            best = candidate;
+            last = j;
+        }
+    }
+    if (last == m) {
+        return;
+    }
+
+    order.push_back(0);
+    size_t mask = full;
+    size_t j = last;
+    while (true) {
+        order.push_back(j + 1);
+        size_t prevMask = mask ^ (size_t(1) << j);
+        if (prevMask == 0) break;
+        const Cost* prev = &dp[prevMask * m];
+        const Cost* in = &toNode[j * m];
+        size_t k = 0;
+        while (k < m && prev[k] + in[k] != dp[mask * m + j]) k++;
+        if (k == m) {
+            order.clear();
+            return;
+        }
+        mask = prevMask;
+        j = k;
+    }
+    order.push_back(0);
+    reverse(order.begin(), order.end());
+}
 
 /**
- * @brief Calculates the Haversine distance between two geographical points.
+ * @brief Solves the TSP exactly using the Held-Karp dynamic programming algorithm, starting at vertex 0.
  *
- * @param lat1 Latitude of the first point.
- * @param lon1 Longitude of the first point.
- * @param lat2 Latitude of the second point.
- * @param lon2 Longitude of the second point.
- * @return double The distance between the two points.
+ * The result is stored in the same place as the backtracking one (getBestTour / getCost).
+ * Costs are kept in double precision while the table fits in HELD_KARP_MEMORY_LIMIT, and in
+ * single precision (half the memory) otherwise; the reported cost is always summed in double.
  *
- * @complexity O(1)
+ * @complexity O(N^2 * 2^N) time and O(N * 2^N) memory, where N is the number of nodes.
  */
+void Data::heldKarpTSP() {
+    bestTour.clear();
+    bestCost = numeric_limits<double>::max();
 
+    Vertex* startVertex = network_.findVertex("0");
+    if (!startVertex) {
+        cerr << "Start node not found in the graph.\n";
+        return;
+    }
 
-double Data::haversineDistance(double lat1, double lon1, double lat2, double lon2) const {
+    vector<Vertex*> nodes;
+    vector<double> dist;
+    buildDistanceTable(startVertex, network_, nodes, dist);
+    const size_t n = nodes.size();
+    if (n < 2) {
+        bestTour = {startVertex, startVertex};
+        bestCost = 0;
+        return;
+    }
 
-    lat1 *= M_PI / 180.0;
-    lon1 *= M_PI / 180.0;
-    lat2 *= M_PI / 180.0;
-    lon2 *= M_PI / 180.0;
+    const size_t m = n - 1;
+    if (m >= 8 * sizeof(size_t) - 4 ||
+        (size_t(1) << m) * m * sizeof(float) > HELD_KARP_MEMORY_LIMIT) {
+        cerr << "Graph too large for Held-Karp (" << n << " nodes).\n";
+        return;
+    }
 
-    const double EARTHRADIUS = 6371000;
+    vector<size_t> order;
+    if ((size_t(1) << m) * m * sizeof(double) <= HELD_KARP_MEMORY_LIMIT) {
+        heldKarpSolve<double>(dist, n, order);
+    }
+    else {
+        heldKarpSolve<float>(dist, n, order);
+    }
+    if (order.empty()) {
+        return;
+    }
 
-    double dLat = lat2 - lat1;
-    double dLon = lon2 - lon1;
-    double a = sin(dLat / 2) * sin(dLat / 2) +
-               cos(lat1) * cos(lat2) *
-               sin(dLon / 2) * sin(dLon / 2);
-    double c = 2 * atan2(sqrt(a), sqrt(1 - a));
-    return EARTHRADIUS * c;
+    bestCost = 0;
+    for (size_t i = 0; i < order.size(); i++) {
+        bestTour.push_back(nodes[order[i]]);
+        if (i > 0) bestCost += dist[order[i - 1] * n + order[i]];
+    }
 }
 
 
 /**
- * @brief Finds the nearest unvisited neighbor of a given vertex.
+ * @brief Depth-first branch-and-bound search over a dense distance table.
  *
- * @param v The vertex to find the nearest neighbor for.
- * @return Vertex* Pointer to the nearest neighbor vertex.
+ * A partial path is discarded when its cost plus an admissible bound on the rest of the tour
+ * reaches the best tour found so far. The cheap bound charges every node that still needs edges
+ * half of its two cheapest incident edges (cheapest-two-edges bound); paths that survive it are
+ * checked against the tighter spanning tree bound of treeBound.
  *
- * @complexity O(E) where E is the number of edges adjacent to the vertex.
+ * Before searching, node penalties pi are chosen by subgradient optimisation of the Held-Karp
+ * 1-tree bound and the search runs on w(i,j) = d(i,j) + pi[i] + pi[j]. Every tour pays exactly
+ * 2 * sum(pi) extra under w, so the optimal tour is the same, but both bounds get much tighter.
  */
-Vertex* Data::findNearestNeighbor(Vertex* v) {
-    Vertex* nearestNeighbor = nullptr;
-    double minDistance = numeric_limits<double>::max();
-    for (Edge* edge : v->getAdj()) {
-        Vertex* neighbor = edge->getDest();
-        if (!neighbor->isVisited()) {
-            double distance = edge->getWeight();
-            if (distance < minDistance) {
-                minDistance = distance;
-                nearestNeighbor = neighbor;
+class BranchAndBound {
+public:
+    BranchAndBound(const vector<double>& dist, size_t n) : dist_(dist), w_(dist), n_(n),
+            visited_(n, false), bestCost_(numeric_limits<double>::infinity()) {}
+
+    /**
+     * @brief Seeds the incumbent with a nearest-neighbour tour improved by 2-opt.
+     *
+     * @complexity O(N^2) per 2-opt pass.
+     */
+    void seed() {
+        vector<size_t> tour;
+        vector<bool> used(n_, false);
+        tour.push_back(0);
+        used[0] = true;
+        while (tour.size() < n_) {
+            size_t last = tour.back(), next = n_;
+            for (size_t j = 0; j < n_; j++) {
+                if (!used[j] && dist_[last * n_ + j] != numeric_limits<double>::infinity() &&
+                    (next == n_ || dist_[last * n_ + j] < dist_[last * n_ + next])) {
+                    next = j;
+                }
             }
+            if (next == n_) return;
+            used[next] = true;
+            tour.push_back(next);
+        }
+        tour.push_back(0);
+
+        bool improved = true;
+        while (improved) {
+            improved = false;
+            for (size_t i = 1; i + 2 < tour.size(); i++) {
+                for (size_t j = i + 1; j + 1 < tour.size(); j++) {
+                    double delta = dist_[tour[i - 1] * n_ + tour[j]] + dist_[tour[i] * n_ + tour[j + 1]]
+                                 - dist_[tour[i - 1] * n_ + tour[i]] - dist_[tour[j] * n_ + tour[j + 1]];
+                    if (delta < -1e-9) {
+                        reverse(tour.begin() + i, tour.begin() + j + 1);
+                        improved = true;
+                    }
+                }
+            }
+        }
+
+        double cost = tourCost(dist_, tour);
+        if (cost < bestCost_) {
+            bestCost_ = cost;
+            bestTour_ = tour;
         }
     }
 
-    return nearestNeighbor;
-}
+    /**
+     * @brief Runs the search from node 0.
+     *
+     * @complexity O(N!) in the worst case, usually far less thanks to pruning.
+     */
+    void solve() {
+        const double inf = numeric_limits<double>::infinity();
+        computePenalties();
+        if (!bestTour_.empty()) bestCost_ = tourCost(w_, bestTour_);
+
+        minOut_.assign(n_, inf);
+        minTwo_.assign(n_, inf);
+        children_.assign(n_, {});
+        for (size_t i = 0; i < n_; i++) {
+            double first = inf, second = inf;
+            for (size_t j = 0; j < n_; j++) {
+                if (j == i || dist_[i * n_ + j] == inf) continue;
+                double w = d(i, j);
+                children_[i].push_back(j);
+                if (w < first) {
+                    second = first;
+                    first = w;
+                }
+                else if (w < second) {
+                    second = w;
+                }
+            }
+            sort(children_[i].begin(), children_[i].end(), [&](size_t a, size_t b) {
+                return d(i, a) < d(i, b);
+            });
+            minOut_[i] = first;
+            minTwo_[i] = first + second;
+        }
+
+        double remaining = 0;
+        for (size_t i = 0; i < n_; i++) remaining += minTwo_[i];
+        if (remaining != inf) {
+            path_.assign(1, 0);
+            visited_[0] = true;
+            // Node 0 only needs its closing edge, every other node needs both of its edges.
+            search(0, remaining - minTwo_[0]);
+        }
+        if (!bestTour_.empty()) bestCost_ = tourCost(dist_, bestTour_);
+    }
+
+    double getBestCost() const { return bestCost_; }
+    const vector<size_t>& getBestTour() const { return bestTour_; }
 
+private:
+    double d(size_t i, size_t j) const { return w_[i * n_ + j]; }
+
+    double tourCost(const vector<double>& table, const vector<size_t>& tour) const {
+        double cost = 0;
+        for (size_t i = 0; i + 1 < tour.size(); i++) cost += table[tour[i] * n_ + tour[i + 1]];
+        return cost;
+    }
+
+    /**
+     * @brief Computes a minimum 1-tree under w_ + pi: a spanning tree of nodes 1..n-1 plus the two
+     * cheapest edges of node 0. Its cost minus 2 * sum(pi) is a lower bound on every tour.
+     *
+     * @param pi Node penalties.
+     * @param degree Output: degree of each node in the 1-tree.
+     * @return The 1-tree cost minus 2 * sum(pi), or infinity if there is none.
+     *
+     * @complexity O(N^2)
+     */
+    double oneTree(const vector<double>& pi, vector<int>& degree) {
+        const double inf = numeric_limits<double>::infinity();
+        degree.assign(n_, 0);
+        key_.assign(n_, inf);
+        parent_.assign(n_, n_);
+        inTree_.assign(n_, false);
+        inTree_[0] = true;
+        key_[1] = 0;
+        double cost = 0;
+        for (size_t step = 1; step < n_; step++) {
+            size_t best = n_;
+            for (size_t i = 1; i < n_; i++) {
+                if (!inTree_[i] && (best == n_ || key_[i] < key_[best])) best = i;
+            }
+            if (key_[best] == inf) return inf;
+            inTree_[best] = true;
+            cost += key_[best];
+            if (parent_[best] != n_) {
+                degree[best]++;
+                degree[parent_[best]]++;
+            }
+            for (size_t i = 1; i < n_; i++) {
+                double w = d(best, i) + pi[best] + pi[i];
+                if (!inTree_[i] && w < key_[i]) {
+                    key_[i] = w;
+                    parent_[i] = best;
+                }
+            }
+        }
+
+        size_t first = n_, second = n_;
+        for (size_t i = 1; i < n_; i++) {
+            double w = d(0, i) + pi[0] + pi[i];
+            if (first == n_ || w < d(0, first) + pi[0] + pi[first]) {
+                second = first;
+                first = i;
+            }
+            else if (second == n_ || w < d(0, second) + pi[0] + pi[second]) {
+                second = i;
+            }
+        }
+        if (second == n_) return inf;
+        cost += d(0, first) + pi[0] + pi[first] + d(0, second) + pi[0] + pi[second];
+        degree[0] = 2;
+        degree[first]++;
+        degree[second]++;
+
+        for (size_t i = 0; i < n_; i++) cost -= 2 * pi[i];
+        return cost;
+    }
+
+    /**
+     * @brief Chooses node penalties by subgradient ascent on the 1-tree bound and folds them into w_.
+     *
+     * @complexity O(K * N^2) where K is the number of subgradient iterations.
+     */
+    void computePenalties() {
+        const double inf = numeric_limits<double>::infinity();
+        if (n_ < 4 || bestCost_ == inf) return;
+
+        vector<double> pi(n_, 0), bestPi(n_, 0);
+        vector<int> degree;
+        double bestBound = -inf;
+        double lambda = 2;
+        size_t stall = 0;
+        for (size_t iteration = 0; iteration < 50 + 10 * n_ && lambda > 1e-6; iteration++) {
+            double bound = oneTree(pi, degree);
+            if (bound == inf) return;
+            if (bound > bestBound + 1e-9) {
+                bestBound = bound;
+                bestPi = pi;
+                stall = 0;
+            }
+            else if (++stall >= n_ / 2) {
+                lambda /= 2;
+                stall = 0;
+            }
+
+            double norm = 0;
+            for (size_t i = 0; i < n_; i++) norm += (degree[i] - 2) * (degree[i] - 2);
+            if (norm == 0) break;  // the 1-tree is a tour, hence optimal
+            double step = lambda * (bestCost_ - bound) / norm;
+            for (size_t i = 0; i < n_; i++) pi[i] += step * (degree[i] - 2);
+        }
+
+        for (size_t i = 0; i < n_; i++) {
+            for (size_t j = 0; j < n_; j++) {
+                if (i != j && w_[i * n_ + j] != inf) w_[i * n_ + j] += bestPi[i] + bestPi[j];
+            }
+        }
+    }
+
+    void search(double cost, double remaining) {
+        size_t last = path_.back();
+        if (path_.size() == n_) {
+            double total = cost + d(last, 0);
+            if (total < bestCost_) {
+                bestCost_ = total;
+                bestTour_ = path_;
+                bestTour_.push_back(0);
+            }
+            return;
+        }
+        for (size_t next : children_[last]) {
+            if (visited_[next]) continue;
+            double childCost = cost + d(last, next);
+            double childRemaining = remaining - minTwo_[next];
+            double bound = childCost + (childRemaining + minOut_[next] + minOut_[0]) / 2;
+            if (bound >= bestCost_) continue;
+            visited_[next] = true;
+            if (path_.size() + 1 < n_ && childCost + treeBound(next) >= bestCost_) {
+                visited_[next] = false;
+                continue;
+            }
+            path_.push_back(next);
+            search(childCost, childRemaining);
+            path_.pop_back();
+            visited_[next] = false;
+        }
+    }
+
+    /**
+     * @brief Lower bound on the cost of closing the tour from last: MST of the unvisited nodes
+     * plus the cheapest edge from last into them and the cheapest edge from them back to node 0.
+     *
+     * @complexity O(U^2) where U is the number of unvisited nodes.
+     */
+    double treeBound(size_t last) {
+        const double inf = numeric_limits<double>::infinity();
+        unvisited_.clear();
+        for (size_t i = 0; i < n_; i++) {
+            if (!visited_[i]) unvisited_.push_back(i);
+        }
+        double enter = inf, leave = inf;
+        for (size_t u : unvisited_) {
+            enter = min(enter, d(last, u));
+            leave = min(leave, d(u, 0));
+        }
+
+        key_.assign(unvisited_.size(), inf);
+        inTree_.assign(unvisited_.size(), false);
+        key_[0] = 0;
+        double tree = 0;
+        for (size_t step = 0; step < unvisited_.size(); step++) {
+            size_t best = unvisited_.size();
+            for (size_t i = 0; i < unvisited_.size(); i++) {
+                if (!inTree_[i] && (best == unvisited_.size() || key_[i] < key_[best])) best = i;
+            }
+            inTree_[best] = true;
+            tree += key_[best];
+            for (size_t i = 0; i < unvisited_.size(); i++) {
+                if (!inTree_[i]) key_[i] = min(key_[i], d(unvisited_[best], unvisited_[i]));
+            }
+        }
+        return tree + enter + leave;
+    }
+
+    const vector<double>& dist_;
+    vector<double> w_;
+    size_t n_;
+    vector<bool> visited_;
+    vector<double> minOut_;
+    vector<double> minTwo_;
+    vector<vector<size_t>> children_;
+    vector<size_t> path_;
+    vector<size_t> bestTour_;
+    double bestCost_;
+    vector<size_t> unvisited_;
+    vector<size_t> parent_;
+    vector<double> key_;
+    vector<bool> inTree_;
+};
 
 /**
- * @brief Finds the Minimum Spanning Tree (MST) of a given graph using Prim's algorithm.
+ * @brief Solves the TSP exactly using branch and bound, starting at vertex 0.
  *
- * @param g Pointer to the graph.
- * @return vector<Vertex*> The vertices of the MST.
+ * Same answer as backtrackingTSP (stored in getBestTour / getCost), but the search starts from a
+ * nearest-neighbour + 2-opt tour, visits the cheapest children first and prunes every partial path
+ * whose cost plus a lower bound on the rest of the tour cannot beat the best tour found so far.
  *
- * @complexity O((V + E) log V) where V is the number of vertices and E is the number of edges.
+ * @complexity O(N!) in the worst case, where N is the number of nodes.
  */
-std::vector<Vertex *> Data::prim(Graph * g) {
-    if (g->getVertexSet().empty()) {
-        return g->getVertexSet();
+void Data::branchAndBoundTSP() {
+    bestTour.clear();
+    bestCost = numeric_limits<double>::max();
+
+    Vertex* startVertex = network_.findVertex("0");
+    if (!startVertex) {
+        cerr << "Start node not found in the graph.\n";
+        return;
     }
-    for(auto v : g->getVertexSet()) {
-        v->setDist(INT_MAX);
-        v->setPath(nullptr);
-        v->setVisited(false);
+
+    vector<Vertex*> nodes;
+    vector<double> dist;
+    buildDistanceTable(startVertex, network_, nodes, dist);
+    const size_t n = nodes.size();
+    if (n < 2) {
+        bestTour = {startVertex, startVertex};
+        bestCost = 0;
+        return;
     }
-    Vertex* s = g->getVertexSet().front();
-    s->setDist(0);
-    MutablePriorityQueue<Vertex> q;
-    q.insert(s);
-    while( ! q.empty() ) {
-        auto v = q.extractMin();
-        v->setVisited(true);
-        for(auto &e : v->getAdj()) {
-            Vertex* w = e->getDest();
-            if (!w->isVisited()) {
-                auto oldDist = w->getDist();
-                if(e->getWeight() < oldDist) {
-                    w->setDist(e->getWeight());
-
-                    w->setPath(e);
-                    if (oldDist == INT_MAX) {
-                        q.insert(w);
-                    }
-                    else {
-                        q.decreaseKey(w);
-                    }
+
+    BranchAndBound search(dist, n);
+    search.seed();
+    search.solve();
+    if (search.getBestTour().empty()) {
+        return;
+    }
+
+    bestCost = search.getBestCost();
+    for (size_t i : search.getBestTour()) {
+        bestTour.push_back(nodes[i]);
+    }
+}
+
+
+/**
+ * Minimum number of subtrees handed to each thread, so that idle threads have something to steal.
+ */
+static const size_t BACKTRACKING_TASKS_PER_THREAD = 8;
+
+/**
+ * @brief Exhaustive backtracking search split into independent subtrees that run on a thread pool.
+ *
+ * The first levels of the search tree are expanded up front; every resulting partial path becomes a
+ * task. Each worker keeps its own path and visited bitset, so the shared graph is only read. The cost
+ * of the best tour lives in an atomic that every worker prunes against; the tour itself is only
+ * written, under a mutex, when a worker finds a cheaper one.
+ */
+class ParallelBacktracking {
+public:
+    ParallelBacktracking(const vector<double>& dist, size_t n, unsigned threads) : dist_(dist), n_(n),
+            pool_(threads), bound_(numeric_limits<double>::infinity()) {
+        children_.assign(n_, {});
+        for (size_t i = 0; i < n_; i++) {
+            for (size_t j = 0; j < n_; j++) {
+                if (j != i && dist_[i * n_ + j] != numeric_limits<double>::infinity()) {
+                    children_[i].push_back(j);
                 }
             }
+            sort(children_[i].begin(), children_[i].end(), [&](size_t a, size_t b) {
+                return dist_[i * n_ + a] < dist_[i * n_ + b];
+            });
+        }
+        states_.resize(pool_.size());
+        for (auto& w : states_) {
+            w.visited.assign((n_ + 63) / 64, 0);
         }
     }
 
-    return g->getVertexSet();
-}
+    /**
+     * @brief Splits the search tree into tasks, runs them and waits for all of them.
+     *
+     * @complexity O(N!) work in the worst case, shared among the threads.
+     */
+    void solve() {
+        struct Prefix {
+            vector<size_t> path;
+            double cost;
+        };
+        vector<Prefix> frontier = {{{0}, 0}};
+        const size_t wanted = pool_.size() * BACKTRACKING_TASKS_PER_THREAD;
+        for (size_t depth = 1; depth + 1 < n_ && frontier.size() < wanted; depth++) {
+            vector<Prefix> expanded;
+            for (const auto& prefix : frontier) {
+                for (size_t next : children_[prefix.path.back()]) {
+                    if (find(prefix.path.begin(), prefix.path.end(), next) != prefix.path.end()) continue;
+                    expanded.push_back(prefix);
+                    expanded.back().path.push_back(next);
+                    expanded.back().cost += dist_[prefix.path.back() * n_ + next];
+                }
+            }
+            frontier.swap(expanded);
+        }
+
+        for (auto& prefix : frontier) {
+            pool_.submit([this, prefix]() {
+                SearchState& w = states_[pool_.currentWorker()];
+                w.path = prefix.path;
+                fill(w.visited.begin(), w.visited.end(), 0);
+                for (size_t v : w.path) {
+                    w.visited[v / 64] |= uint64_t(1) << (v % 64);
+                }
+                search(w, prefix.cost);
+            });
+        }
+        pool_.wait();
+    }
 
+    double getBestCost() const { return bound_.load(); }
+    const vector<size_t>& getBestTour() const { return bestTour_; }
+
+private:
+    struct SearchState {
+        vector<size_t> path;
+        vector<uint64_t> visited;
+    };
+
+    /**
+     * @brief Extends the worker's path in every possible way, pruning against the shared best cost.
+     *
+     * @complexity O((N - depth)!) in the worst case.
+     */
+    void search(SearchState& w, double cost) {
+        if (cost >= bound_.load(memory_order_relaxed)) return;
+        size_t last = w.path.back();
+        if (w.path.size() == n_) {
+            double total = cost + dist_[last * n_];
+            if (total < bound_.load(memory_order_relaxed)) {
+                lock_guard<mutex> guard(bestLock_);
+                if (total < bound_.load(memory_order_relaxed)) {
+                    bestTour_ = w.path;
+                    bestTour_.push_back(0);
+                    bound_.store(total, memory_order_relaxed);
+                }
+            }
+            return;
+        }
+        for (size_t next : children_[last]) {
+            uint64_t bit = uint64_t(1) << (next % 64);
+            if (w.visited[next / 64] & bit) continue;
+            w.visited[next / 64] |= bit;
+            w.path.push_back(next);
+            search(w, cost + dist_[last * n_ + next]);
+            w.path.pop_back();
+            w.visited[next / 64] &= ~bit;
+        }
+    }
+
+    const vector<double>& dist_;
+    size_t n_;
+    vector<vector<size_t>> children_;
+    ThreadPool pool_;
+    vector<SearchState> states_;
+    atomic<double> bound_;
+    mutex bestLock_;
+    vector<size_t> bestTour_;
+};
 
 /**
- * @brief Performs a depth-first search (DFS) on the MST starting from a given vertex.
+ * @brief Solves the TSP by exhaustive backtracking from vertex "0", split across a pool of threads.
  *
- * @param v The starting vertex for DFS.
- * @param mst The vertices of the MST.
+ * Finds the same optimal cost as backtrackingTSP without touching the Vertex visited flags.
  *
- * @complexity O(V + E) where V is the number of vertices and E is the number of edges in the MST.
+ * @param threads The number of worker threads.
+ *
+ * @complexity O(N!) work where N is the number of nodes, divided among the threads.
  */
-void Data::dfsMST(Vertex* v, const std::vector<Vertex*>& mst) {
-    v->setVisited(true);
+void Data::parallelBacktrackingTSP(unsigned threads) {
+    bestTour.clear();
+    bestCost = numeric_limits<double>::max();
 
-    if (std::find(aproximation_tour_.begin(), aproximation_tour_.end(), v) == aproximation_tour_.end()) {
-        aproximation_tour_.push_back(v);
+    Vertex* startVertex = network_.findVertex("0");
+    if (!startVertex) {
+        cerr << "Start node not found in the graph.\n";
+        return;
+    }
+
+    vector<Vertex*> nodes;
+    vector<double> dist;
+    buildDistanceTable(startVertex, network_, nodes, dist);
+    const size_t n = nodes.size();
+    if (n < 2) {
+        bestTour = {startVertex, startVertex};
+        bestCost = 0;
+        return;
+    }
+
+    ParallelBacktracking search(dist, n, threads);
+    search.solve();
+    if (search.getBestTour().empty()) {
+        return;
     }
 
-    for (auto& edge : v->getAdj()) {
-        Vertex* neighbor = edge->getDest();
-        if (!neighbor->isVisited()) {
-            aproximation_tourCost_ += edge->getWeight();
-            dfsMST(neighbor, mst);
+    bestCost = search.getBestCost();
+    for (size_t i : search.getBestTour()) {
+        bestTour.push_back(nodes[i]);
+    }
+}
+
+
+/**
+ * @brief Calculates the cost of a given tour.
+ *
+ * Consecutive vertices without an edge between them cost their haversine distance, from the
+ * coordinates the network precomputes on freeze() (see GeoDistances), when both have coordinates.
+ * A vertex repeated in a row (the tour of a single vertex) costs nothing.
+ *
+ * @param tour The tour path as a vector of vertices.
+ * @return double The total cost of the tour, or -1 if two consecutive vertices have neither an edge nor coordinates.
+ *
+ * @complexity O(N) on dense graphs, O(N * D) otherwise, where N is the number of nodes in the tour and D the maximum degree.
+ */
+double Data::calculateTourCost(const vector<Vertex*>& tour) const {
+    double cost = 0;
+    int nodenr=0;
+    for (size_t i = 0; i < tour.size() - 1; ++i) {
+        Vertex* v1 = tour[i];
+        Vertex* v2 = tour[i + 1];
+        if (v1 == v2) {
+            nodenr++;
+            continue;
+        }
+        double weight = network_.getEdgeWeight(v1->getId(), v2->getId());
+        bool haveEdge = weight != numeric_limits<double>::infinity();
+        if (haveEdge) {
+            cost += weight;
+            nodenr++;
+        }
+        if(!haveEdge && v1->hasCoord() && v2->hasCoord()) {
+            cost += network_.getGeoDistances().distance(v1->getId(), v2->getId());
+            nodenr++;
         }
     }
+    if(nodenr+1 < tour.size()) {
+        return -1;
+    }
+    return cost;
 }
 
 
+/**
+ * @brief Returns the best tour cost found by the backtracking algorithm.
+ *
+ * @return double The cost of the best tour.
+ *
+ * @complexity O(1)
+ */
+double Data::getCost() {
+    return bestCost;
+}
 
 
 
+/**
+ * @brief Finds the cheapest edge from a vertex to a neighbour accepted by a filter.
+ *
+ * When the graph has candidate lists, the k cheapest neighbours are tried first, cheapest first, and the
+ * first accepted one is the answer; only when none of them is accepted are all edges scanned. Both ways
+ * give the same vertex, ties included.
+ *
+ * @param graph The frozen graph.
+ * @param v The vertex id.
+ * @param accept Tells whether a neighbour id may be chosen.
+ * @return int The id of the nearest accepted neighbour, or -1 if there is none.
+ *
+ * @complexity O(k) when a candidate is accepted, O(k + D) otherwise, where D is the degree of the vertex.
+ */
+template <class Accept>
+static int nearestAccepted(const Graph& graph, int v, Accept accept) {
+    if (graph.hasCandidates()) {
+        const CandidateLists& lists = graph.getCandidates();
+        unsigned end = std::min(lists.begin(v) + lists.getK(), lists.end(v));
+        for (unsigned c = lists.begin(v); c < end; c++) {
+            if (accept(lists.getTarget(c))) return lists.getTarget(c);
+        }
+    }
+    const CSRGraph& csr = graph.getCSR();
+    int nearest = -1;
+    double minDistance = numeric_limits<double>::max();
+    for (unsigned e = csr.edgesBegin(v); e < csr.edgesEnd(v); e++) {
+        if (csr.getWeight(e) < minDistance && accept(csr.getTarget(e))) {
+            minDistance = csr.getWeight(e);
+            nearest = csr.getTarget(e);
+        }
+    }
+    return nearest;
+}
 
 /**
- * @brief Returns the tour found by the approximation algorithm.
+ * @brief Finds the nearest unvisited neighbor of a given vertex.
  *
- * @return vector<Vertex*> The tour as a vector of vertices.
+ * @param v The vertex to find the nearest neighbor for.
+ * @param state Marks the visited vertices.
+ * @return Vertex* Pointer to the nearest neighbor vertex.
  *
- * @complexity O(1)
+ * @complexity O(k) with candidate lists when one of them is unvisited, O(E) otherwise, where E is the number of edges adjacent to the vertex.
+ */
+Vertex* Data::findNearestNeighbor(Vertex* v, const Workspace& state) {
+    int nearest = nearestAccepted(network_, v->getId(), [&state](int u) {
+        return !state.isVisited(u);
+    });
+    return nearest == -1 ? nullptr : network_.getVertex(nearest);
+}
+
+
+/**
+ * @brief Stores a spanning tree given as a parent array in a workspace, the way Data::prim leaves it.
+ *
+ * Each vertex gets the edge from its parent (given by its CSR index, see SpanningTree::findTreeEdges) as
+ * its path and the weight as its dist; vertices with an infinite weight stay unvisited.
+ *
+ * @param g The frozen graph.
+ * @param parent The parent of every vertex, -1 for the root and unreachable vertices.
+ * @param weight The weight of every tree edge.
+ * @param edge The CSR index of every tree edge, SpanningTree::NO_EDGE for none.
+ * @param mst The workspace to fill, sized for the graph.
+ *
+ * @complexity Time Complexity: O(V)
+ */
+static void hangFromParents(const Graph& g, const std::vector<int>& parent, const std::vector<double>& weight,
+                            const std::vector<unsigned>& edge, Workspace& mst) {
+    const CSRGraph& csr = g.getCSR();
+    for (int id = 0; id < g.getNumVertex(); id++) {
+        int p = parent[id];
+        mst.setVisited(id, weight[id] != numeric_limits<double>::infinity());
+        mst.setDist(id, weight[id]);
+        mst.setParent(id, p);
+        if (p != -1 && edge[id] != SpanningTree::NO_EDGE) {
+            // After freeze the adjacency list of p is in CSR order.
+            mst.setPath(id, g.getVertex(p)->getAdj()[edge[id] - csr.edgesBegin(p)]);
+        }
+    }
+}
+
+
+/**
+ * @brief Finds the Minimum Spanning Tree (MST) of a given graph using Prim's algorithm.
+ *
+ * The graph is only read: every vertex gets, in the returned workspace, the tree edge it hangs from
+ * (Workspace::getPath, nullptr for the root and unreachable vertices), its parent (-1 for those) and the
+ * weight of that edge (Workspace::getDist); reached vertices are marked visited. Dense graphs (those with
+ * a dense weight matrix, see Graph::freeze) run the heap-free array version (SpanningTree::densePrim) on
+ * the matrix. Sparse graphs of at least SpanningTree::PARALLEL_MIN_VERTICES vertices, given at least
+ * SpanningTree::PARALLEL_MIN_THREADS threads, run the parallel Borůvka (SpanningTree::boruvka) on the CSR
+ * arrays; the others use a heap over the adjacency lists, which does less work in total.
+ *
+ * @param g The graph; the tree is rooted at its first vertex.
+ * @param threads The number of threads Borůvka may use.
+ * @return Workspace The MST, indexed by vertex id.
+ *
+ * @complexity O(V^2) on dense graphs, O(E log V / T) with Borůvka on T threads, O((V + E) log V) otherwise, where V is the number of vertices and E is the number of edges.
  */
-void Data::createMstGraph(Graph &mstGraph, std::vector<Vertex*>  mst) {
-    for(auto v : mst) {
-        mstGraph.addVertex(v->getInfo(),v->getLong(),v->getLat(), v->hasCoord());
-        auto ep = v->getPath();
-        if (ep != nullptr) {
-            if(!mstGraph.addBidirectionalEdge(ep->getOrig()->getInfo(),ep->getDest()->getInfo(),ep->getWeight())) {
-                mstGraph.addVertex(ep->getOrig()->getInfo(),ep->getOrig()->getLong(),ep->getOrig()->getLat(), ep->getOrig()->hasCoord());
-                mstGraph.addVertex(ep->getDest()->getInfo(),ep->getDest()->getLong(),ep->getDest()->getLat(), ep->getDest()->hasCoord());
-                mstGraph.addBidirectionalEdge(ep->getOrig()->getInfo(),ep->getDest()->getInfo(),ep->getWeight());
+Workspace Data::prim(const Graph& g, unsigned threads) const {
+    Workspace mst(g.getNumVertex());
+    if (g.getVertexSet().empty()) {
+        return mst;
+    }
+    if (g.isFrozen() && g.hasDistanceMatrix()) {
+        std::vector<double> weight;
+        std::vector<int> parent = SpanningTree::densePrim(g.getDistanceMatrix(), 0, weight);
+        std::vector<unsigned> edge(parent.size(), SpanningTree::NO_EDGE);
+        SpanningTree::findTreeEdges(g.getCSR(), parent, weight, edge);
+        hangFromParents(g, parent, weight, edge, mst);
+        return mst;
+    }
+    if (g.isFrozen() && threads >= SpanningTree::PARALLEL_MIN_THREADS &&
+        g.getNumVertex() >= SpanningTree::PARALLEL_MIN_VERTICES) {
+        std::vector<double> weight;
+        std::vector<unsigned> edge;
+        std::vector<int> parent = SpanningTree::boruvka(g.getCSR(), 0, threads, weight, edge);
+        hangFromParents(g, parent, weight, edge, mst);
+        return mst;
+    }
+    int s = g.getVertexSet().front()->getId();
+    mst.setDist(s, 0);
+    DAryHeap<double> q(g.getNumVertex());
+    q.push(s, 0);
+    while( ! q.empty() ) {
+        int v = q.pop();
+        mst.setVisited(v, true);
+        for(auto &e : g.getVertex(v)->getAdj()) {
+            int w = e->getDest()->getId();
+            if (!mst.isVisited(w) && e->getWeight() < mst.getDist(w)) {
+                mst.setDist(w, e->getWeight());
+                mst.setPath(w, e);
+                mst.setParent(w, v);
+                q.pushOrDecrease(w, e->getWeight());
             }
         }
     }
+
+    return mst;
 }
 
 
 /**
  * @brief Approximates the TSP solution using a triangular heuristic starting from a given node.
  *
+ * The tour is a preorder walk (RootedTree::preorder) of the minimum spanning tree found by Data::prim,
+ * read straight from its parent array.
+ *
  * @param startNodeId The ID of the starting node.
  *
  * @complexity O((V + E) log V) where V is the number of vertices and E is the number of edges.
@@ -468,13 +1805,11 @@ void Data::triangularHeuristicAproximation(const string& startNodeId) {
         cerr << "Start node not found in the graph.\n";
         return;
     }
-    std::vector<Vertex*> mst = prim(&network_);
-    resetNodesVisitation();
-    Graph mstGraph;
-    createMstGraph(mstGraph,mst);
-    auto tour = mstGraph.dfs();
-    for(auto s: tour) {
-        aproximation_tour_.push_back(network_.findVertex(s));
+    Workspace mst = prim(network_, ThreadPool::defaultThreads());
+    RootedTree tree(mst.getParents());
+    aproximation_tour_.reserve(mst.size() + 1);
+    for (int id : tree.preorder(network_.getVertexSet().front()->getId())) {
+        aproximation_tour_.push_back(network_.getVertex(id));
     }
     aproximation_tour_.push_back(startVertex);
     aproximation_tourCost_ = calculateTourCost(aproximation_tour_);
@@ -487,7 +1822,7 @@ void Data::triangularHeuristicAproximation(const string& startNodeId) {
  *
  * @complexity O(1)
  */
-vector<Vertex*> Data::getAproximationTour() {
+const vector<Vertex*>& Data::getAproximationTour() const {
     return aproximation_tour_;
 }
 
@@ -513,7 +1848,6 @@ double Data::getAproximationTourCost() {
  */
 void Data::clusterApproximationTSP(const string& startNodeId){
     const auto& vertices = network_.getVertexSet();
-    unordered_set<Vertex*> unvisited(vertices.begin(), vertices.end());
 
     cluster_tour_.clear();
     cluster_tourCost_ = 0.0;
@@ -524,40 +1858,30 @@ void Data::clusterApproximationTSP(const string& startNodeId){
         return;
     }
 
+    Workspace state(network_.getNumVertex());
     cluster_tour_.push_back(startVertex);
-    startVertex->setVisited(true);
-    unvisited.erase(startVertex);
+    state.setVisited(startVertex->getId(), true);
 
     while (cluster_tour_.size() < vertices.size()) {
         Vertex* lastVertex = cluster_tour_.back();
-        Vertex* nearestNeighbor = findNearestNeighborCluster(lastVertex, unvisited);
+        Vertex* nearestNeighbor = findNearestNeighborCluster(lastVertex, state);
 
         if (nearestNeighbor) {
-            nearestNeighbor->setVisited(true);
+            state.setVisited(nearestNeighbor->getId(), true);
             cluster_tour_.push_back(nearestNeighbor);
 
-            for (Edge* edge : lastVertex->getAdj()) {
-                if (edge->getDest() == nearestNeighbor) {
-                    cluster_tourCost_ += edge->getWeight();
-                    break;
-                }
-            }
-
-            unvisited.erase(nearestNeighbor);
+            cluster_tourCost_ += network_.getEdgeWeight(lastVertex->getId(), nearestNeighbor->getId());
         } else {
             break;
         }
     }
 
-    for (Edge* edge : startVertex->getAdj()) {
-        if (edge->getDest() == cluster_tour_.back()) {
-            cluster_tourCost_ += edge->getWeight();
-            break;
-        }
+    double closing = network_.getEdgeWeight(startVertex->getId(), cluster_tour_.back()->getId());
+    if (closing != numeric_limits<double>::infinity()) {
+        cluster_tourCost_ += closing;
     }
 
     cluster_tour_.push_back(startVertex);
-    resetNodesVisitation();
 }
 
 
@@ -565,27 +1889,16 @@ void Data::clusterApproximationTSP(const string& startNodeId){
  * @brief Finds the nearest neighbor for clustering approach considering unvisited nodes.
  *
  * @param v The current vertex.
- * @param unvisited Set of unvisited vertices.
+ * @param state Marks the vertices already in the tour.
  * @return Vertex* Pointer to the nearest neighbor vertex.
  *
- * @complexity O(E) where E is the number of edges adjacent to the vertex.
+ * @complexity O(k) with candidate lists when one of them is accepted, O(E) otherwise, where E is the number of edges adjacent to the vertex.
  */
-Vertex* Data::findNearestNeighborCluster(Vertex* v, const unordered_set<Vertex*>& unvisited) {
-    Vertex* nearestNeighbor = nullptr;
-    double minDistance = numeric_limits<double>::max();
-
-    for (Edge* edge : v->getAdj()) {
-        Vertex* neighbor = edge->getDest();
-        if (!neighbor->isVisited() && unvisited.count(neighbor)) {
-            double distance = edge->getWeight();
-            if (distance < minDistance) {
-                minDistance = distance;
-                nearestNeighbor = neighbor;
-            }
-        }
-    }
-
-    return nearestNeighbor;
+Vertex* Data::findNearestNeighborCluster(Vertex* v, const Workspace& state) {
+    int nearest = nearestAccepted(network_, v->getId(), [&state](int u) {
+        return !state.isVisited(u);
+    });
+    return nearest == -1 ? nullptr : network_.getVertex(nearest);
 }
 
 
@@ -597,7 +1910,7 @@ Vertex* Data::findNearestNeighborCluster(Vertex* v, const unordered_set<Vertex*>
  *
  * @complexity O(1)
  */
-vector<Vertex*> Data::getClusterTour() {
+const vector<Vertex*>& Data::getClusterTour() const {
     return cluster_tour_;
 }
 
@@ -630,50 +1943,58 @@ void Data::mstApproximationTSP(const string& startNodeId) {
         return;
     }
 
-    MutablePriorityQueue<Vertex> pq;
-    pq.insert(startVertex);
-
-    vector<bool> visited(network_.getVertexSet().size(), false);
-    visited[stoi(startVertex->getInfo())] = true;
+    // Every vertex hangs from the vertex that first reached it; the cheapest such edge is expanded first.
+    Workspace tree(network_.getNumVertex());
+    DAryHeap<double> pq(network_.getNumVertex());
+    pq.push(startVertex->getId(), 0);
+    tree.setVisited(startVertex->getId(), true);
 
     while (!pq.empty()) {
-        Vertex* u = pq.extractMin();
+        int u = pq.pop();
 
-        for (Edge* edge : u->getAdj()) {
-            Vertex* v = edge->getDest();
-            double weight = edge->getWeight();
-            int vIndex = stoi(v->getInfo());
+        for (Edge* edge : network_.getVertex(u)->getAdj()) {
+            int v = edge->getDest()->getId();
 
-            if (!visited[vIndex]) {
-                v->setParent(u);
-                pq.insert(v);
-                visited[vIndex] = true;
+            if (!tree.isVisited(v)) {
+                tree.setParent(v, u);
+                pq.push(v, edge->getWeight());
+                tree.setVisited(v, true);
             }
         }
     }
 
-    preorderTraversalMST(startVertex);
+    preorderTraversalMST(startVertex, tree);
 
     mst_tourCost_ = calculateTourCost(mst_tour_);
-    resetNodesVisitation();
 }
 
 
 /**
  * @brief Performs a preorder traversal on the MST starting from a given vertex.
  *
+ * The children of a vertex are the neighbours whose parent (Workspace::getParent) it is, in adjacency
+ * order; the walk uses an explicit stack, so it is safe on path-like trees of any depth.
+ *
  * @param u The starting vertex.
+ * @param tree The parent of every vertex.
  *
  * @complexity O(V + E) where V is the number of vertices and E is the number of edges in the MST.
  */
-void Data::preorderTraversalMST(Vertex* u) {
+void Data::preorderTraversalMST(Vertex* u, const Workspace& tree) {
+    std::vector<std::pair<Vertex*, unsigned>> stack;
     mst_tour_.push_back(u);
-
-    for (Edge* edge : u->getAdj()) {
-        Vertex* v = edge->getDest();
-
-        if (v->getParent() == u) {
-            preorderTraversalMST(v);
+    stack.push_back({u, 0});
+    while (!stack.empty()) {
+        auto& top = stack.back();
+        const auto& adj = top.first->getAdj();
+        if (top.second == adj.size()) {
+            stack.pop_back();
+            continue;
+        }
+        Vertex* v = adj[top.second++]->getDest();
+        if (tree.getParent(v->getId()) == top.first->getId()) {
+            mst_tour_.push_back(v);
+            stack.push_back({v, 0});
         }
     }
 }
@@ -685,7 +2006,7 @@ void Data::preorderTraversalMST(Vertex* u) {
  *
  * @complexity O(1)
  */
-vector<Vertex*> Data::getMSTTour() {
+const vector<Vertex*>& Data::getMSTTour() const {
     return mst_tour_;
 }
 
@@ -704,6 +2025,220 @@ double Data::getMSTTourCost() {
 
 
 
+/**
+ * @brief Builds a nearest-neighbour tour by geographic distance, starting from a given node.
+ *
+ * The next vertex is always the closest unvisited one by haversine distance, found through a k-d tree
+ * over the vertex coordinates instead of a scan of the adjacency, so it works whether or not the two
+ * vertices share an edge. Every vertex needs coordinates; the tour cost is that of calculateTourCost.
+ *
+ * @param startNodeId The ID of the starting node.
+ *
+ * @complexity O(V log V) on typical inputs, where V is the number of vertices.
+ */
+void Data::geometricNearestNeighbourTSP(const string& startNodeId) {
+    geometric_tour_.clear();
+    geometric_tourCost_ = 0.0;
+
+    Vertex* startVertex = network_.findVertex(startNodeId);
+    if (!startVertex) {
+        cerr << "Start node not found in the graph.\n";
+        return;
+    }
+    KdTree tree(network_);
+    if (tree.size() != network_.getNumVertex()) {
+        cerr << "Every vertex needs coordinates.\n";
+        return;
+    }
+
+    int current = startVertex->getId();
+    geometric_tour_.push_back(startVertex);
+    tree.markVisited(current);
+    for (int step = 1; step < tree.size(); step++) {
+        current = tree.nearest(current);
+        tree.markVisited(current);
+        geometric_tour_.push_back(network_.getVertex(current));
+    }
+    geometric_tour_.push_back(startVertex);
+    geometric_tourCost_ = calculateTourCost(geometric_tour_);
+}
+
+/**
+ * @brief Returns the tour found by the geometric nearest-neighbour heuristic.
+ *
+ * @return vector<Vertex*> The tour as a vector of vertices.
+ *
+ * @complexity O(1)
+ */
+const vector<Vertex*>& Data::getGeometricTour() const {
+    return geometric_tour_;
+}
+
+/**
+ * @brief Returns the cost of the tour found by the geometric nearest-neighbour heuristic.
+ *
+ * @return double The cost of the tour.
+ *
+ * @complexity O(1)
+ */
+double Data::getGeometricTourCost() {
+    return geometric_tourCost_;
+}
+
+/**
+ * @brief Approximates the TSP solution with the Christofides heuristic, starting from a given node.
+ *
+ * Phases: the minimum spanning tree (Data::prim), its odd-degree vertices, a minimum-weight perfect
+ * matching between them (see PerfectMatching), an Euler circuit of the tree plus the matching
+ * (Hierholzer's algorithm) and its shortcut to a tour, skipping vertices already visited. With the exact
+ * matching and weights that satisfy the triangle inequality the tour costs at most 1.5 times the optimum.
+ * Without a dense weight matrix the odd vertices are matched on their metric closure (see MetricClosure);
+ * if some of them can only be matched over a missing edge (or no path at all) the tour is left empty.
+ * The time of every phase is kept (see getChristofidesPhases).
+ *
+ * @param startNodeId The ID of the starting node.
+ * @param exactMatching True for the exact (blossom) matching, false for the greedy one.
+ *
+ * @complexity O((V + E) log V + K^3) with the exact matching and O((V + E) log V + K^2 log K) with the greedy one,
+ * where K is the number of odd-degree vertices of the tree, plus O(K (V + E) log V) for the metric closure
+ * on graphs without a dense weight matrix.
+ */
+void Data::christofidesTSP(const string& startNodeId, bool exactMatching) {
+    christofides_tour_.clear();
+    christofides_tourCost_ = 0.0;
+    christofides_phases_.clear();
+
+    Vertex* startVertex = network_.findVertex(startNodeId);
+    if (!startVertex) {
+        cerr << "Start node not found in the graph.\n";
+        return;
+    }
+    auto clock = chrono::steady_clock::now();
+    auto lap = [this, &clock](const string& phase) {
+        auto now = chrono::steady_clock::now();
+        christofides_phases_.emplace_back(phase, chrono::duration<double>(now - clock).count());
+        clock = now;
+    };
+
+    const int n = network_.getNumVertex();
+    vector<pair<int, int>> edges;
+    vector<int> degree(n, 0);
+    Workspace mst = prim(network_, ThreadPool::defaultThreads());
+    for (int v = 0; v < n; v++) {
+        if (mst.getParent(v) != -1) {
+            edges.emplace_back(mst.getParent(v), v);
+        }
+    }
+    if ((int) edges.size() != n - 1) {
+        cerr << "The graph is not connected.\n";
+        return;
+    }
+    lap("Spanning tree");
+
+    for (const auto& e : edges) {
+        degree[e.first]++;
+        degree[e.second]++;
+    }
+    vector<int> odd;
+    for (int v = 0; v < n; v++) {
+        if (degree[v] % 2 == 1) odd.push_back(v);
+    }
+    lap("Odd vertices");
+
+    // Without a dense matrix most odd pairs have no edge, so they are matched on shortest-path distances;
+    // a matched pair then stands for its shortest path, whose inner vertices the shortcutting skips.
+    MetricClosure closure;
+    bool sparse = !network_.hasDistanceMatrix();
+    if (sparse) {
+        closure.build(network_.getCSR(), odd, ThreadPool::defaultThreads());
+    }
+    DistanceMatrix weights(odd.size(), false, numeric_limits<double>::infinity());
+    for (size_t i = 0; i < odd.size(); i++) {
+        for (size_t j = 0; j < odd.size(); j++) {
+            if (i != j) weights.set(i, j, sparse ? closure.get(i, j) : network_.getEdgeWeight(odd[i], odd[j]));
+        }
+    }
+    PerfectMatching matching(weights);
+    vector<int> mate = exactMatching ? matching.blossom() : matching.greedy();
+    for (size_t i = 0; i < odd.size(); i++) {
+        if (mate[i] == -1 || weights.get(i, mate[i]) == numeric_limits<double>::infinity()) {
+            cerr << "The odd-degree vertices cannot be matched without a missing edge.\n";
+            christofides_phases_.clear();
+            return;
+        }
+        if (mate[i] > (int) i) edges.emplace_back(odd[i], odd[mate[i]]);
+    }
+    lap(exactMatching ? "Matching (exact)" : "Matching (greedy)");
+
+    vector<vector<int>> incident(n);
+    for (size_t e = 0; e < edges.size(); e++) {
+        incident[edges[e].first].push_back(e);
+        incident[edges[e].second].push_back(e);
+    }
+    vector<bool> used(edges.size(), false);
+    vector<size_t> next(n, 0);
+    vector<int> circuit;
+    vector<int> stack = {startVertex->getId()};
+    while (!stack.empty()) {
+        int v = stack.back();
+        while (next[v] < incident[v].size() && used[incident[v][next[v]]]) next[v]++;
+        if (next[v] == incident[v].size()) {
+            circuit.push_back(v);
+            stack.pop_back();
+            continue;
+        }
+        int e = incident[v][next[v]];
+        used[e] = true;
+        stack.push_back(edges[e].first == v ? edges[e].second : edges[e].first);
+    }
+    lap("Euler circuit");
+
+    vector<bool> visited(n, false);
+    for (int v : circuit) {
+        if (!visited[v]) {
+            visited[v] = true;
+            christofides_tour_.push_back(network_.getVertex(v));
+        }
+    }
+    christofides_tour_.push_back(startVertex);
+    christofides_tourCost_ = calculateTourCost(christofides_tour_);
+    lap("Shortcutting");
+}
+
+/**
+ * @brief Returns the tour found by the Christofides heuristic.
+ *
+ * @return vector<Vertex*> The tour as a vector of vertices.
+ *
+ * @complexity O(1)
+ */
+const std::vector<Vertex*>& Data::getChristofidesTour() const {
+    return christofides_tour_;
+}
+
+/**
+ * @brief Returns the cost of the tour found by the Christofides heuristic.
+ *
+ * @return double The cost of the tour.
+ *
+ * @complexity O(1)
+ */
+double Data::getChristofidesTourCost() {
+    return christofides_tourCost_;
+}
+
+/**
+ * @brief Returns the time taken by every phase of the last run of the Christofides heuristic.
+ *
+ * @return Pairs of (phase name, seconds), in the order the phases ran.
+ *
+ * @complexity O(1)
+ */
+const std::vector<std::pair<std::string, double>>& Data::getChristofidesPhases() const {
+    return christofides_phases_;
+}
+
+
 /**
  * @brief Returns the best tour found by the backtracking algorithm.
  *
@@ -711,7 +2246,7 @@ double Data::getMSTTourCost() {
  *
  * @complexity O(1)
  */
-std::vector<Vertex *> Data::getBestTour() {
+const std::vector<Vertex *>& Data::getBestTour() const {
     return bestTour;
 }
 
@@ -726,8 +2261,6 @@ bool Data::isTourism() {
     return tourism;
 }
 
-const int INF = std::numeric_limits<int>::max();
-
 /**
  * @brief Performs BFS to find the farthest node from a given start node.
  *
@@ -737,132 +2270,121 @@ const int INF = std::numeric_limits<int>::max();
  * @complexity O(V + E) where V is the number of vertices and E is the number of edges.
  */
 std::string Data::bfs_farthest_node(const std::string& start) {
-    std::unordered_set<std::string> visited;
-    std::queue<std::pair<std::string, int>> q; // par (nó, distância)
-    q.push({start, 0});
-    visited.insert(start);
-
-    std::string farthest_node = start;
+    int source = network_.findVertexIdx(start);
+    if (source == -1) {
+        return start;
+    }
+    const CSRGraph& csr = network_.getCSR();
+    std::vector<int> distance(csr.getNumVertex(), -1);
+    std::vector<int> q; // fila de nós, por ordem de distância
+    q.reserve(csr.getNumVertex());
+    q.push_back(source);
+    distance[source] = 0;
+
+    int farthest_node = source;
     int max_distance = 0;
 
-    while (!q.empty()) {
-        auto [node, dist] = q.front();
-        q.pop();
+    for (size_t head = 0; head < q.size(); head++) {
+        int node = q[head];
+        int dist = distance[node];
 
         if (dist > max_distance) {
             max_distance = dist;
             farthest_node = node;
         }
 
-        Vertex* vertex = network_.findVertex(node);
-        if (vertex != nullptr) {
-            for (const auto& edge : vertex->getAdj()) {
-                std::string neighbor = edge->getDest()->getInfo();
-                if (visited.find(neighbor) == visited.end()) {
-                    visited.insert(neighbor);
-                    q.push({neighbor, dist + 1});
-                }
+        for (unsigned e = csr.edgesBegin(node); e < csr.edgesEnd(node); e++) {
+            int neighbor = csr.getTarget(e);
+            if (distance[neighbor] == -1) {
+                distance[neighbor] = dist + 1;
+                q.push_back(neighbor);
             }
         }
     }
 
-    return farthest_node;
+    return network_.getVertex(farthest_node)->getInfo();
 }
 
 
 /**
  * @brief Performs Dijkstra's algorithm to find shortest paths from a start node.
  *
+ * Runs on the ShortestPaths engine, with the exact (double) edge weights.
+ *
  * @param start The starting node.
- * @return unordered_map<string, int> The shortest path distances from the start node.
+ * @return vector<double> The shortest path distances from the start node, indexed by vertex id (infinity if unreachable).
  *
  * @complexity O((V + E) log V) where V is the number of vertices and E is the number of edges.
  */
-std::unordered_map<std::string, int> Data::dijkstra(const std::string& start) {
-    std::unordered_map<std::string, int> distances;
-    for (const auto& vertex : network_.getVertexSet()) {
-        distances[vertex->getInfo()] = INF;
+std::vector<double> Data::dijkstra(const std::string& start) {
+    const CSRGraph& csr = network_.getCSR();
+    std::vector<double> distances(csr.getNumVertex(), numeric_limits<double>::infinity());
+    int source = network_.findVertexIdx(start);
+    if (source == -1) {
+        return distances;
     }
-    distances[start] = 0;
-
-    std::priority_queue<std::pair<int, std::string>, std::vector<std::pair<int, std::string>>, std::greater<>> pq;
-    pq.push({0, start});
-
-    while (!pq.empty()) {
-        auto [current_distance, current_node] = pq.top();
-        pq.pop();
-
-        if (current_distance > distances[current_node]) continue;
-
-        Vertex* node = network_.findVertex(current_node);
-        for (auto& edge : node->getAdj()) {
-            Vertex* neighbor = edge->getDest();
-            int weight = edge->getWeight();
-
-            int distance = current_distance + weight;
-            if (distance < distances[neighbor->getInfo()]) {
-                distances[neighbor->getInfo()] = distance;
-                pq.push({distance, neighbor->getInfo()});
-            }
-        }
+    ShortestPaths& paths = shortestPaths();
+    paths.run(source);
+    for (int v : paths.getSettledOrder()) {
+        distances[v] = paths.getDist(v);
     }
-
     return distances;
 }
 
 
-
 /**
  * @brief Solves the Traveling Salesman Problem (TSP) using a heuristic approach for real-world graphs.
  *
+ * Greedy nearest neighbour along the edges of the graph: from the current node, move to the unvisited
+ * neighbour with the lightest edge. Gives up (empty tour) when every neighbour is already visited.
+ *
  * @param start The starting node ID.
  * @return std::vector<std::string> The tour path as a vector of node IDs.
  *
- * @complexity O(V^2) where V is the number of vertices. This includes the BFS, Dijkstra, and the main loop.
+ * @complexity O(V + E) where V is the number of vertices and E is the number of edges, including the connectivity check.
  */
 std::vector<std::string> Data::tsp_real_world1(std::string start) {
     if (network_.getVertexSet().empty() || !isConnected(start)) {
         return {};
     }
 
-    std::string farthest_node = bfs_farthest_node(start);
-    auto distances_from_farthest = dijkstra(farthest_node);
-
-    std::unordered_set<std::string> visited;
-    std::vector<std::string> path;
-    std::string current_node = start;
-    visited.insert(current_node);
+    const CSRGraph& csr = network_.getCSR();
+    std::vector<bool> visited(csr.getNumVertex(), false);
+    std::vector<int> path;
+    int current_node = network_.findVertexIdx(start);
+    visited[current_node] = true;
     path.push_back(current_node);
 
-    while (visited.size() < network_.getVertexSet().size()) {
-        std::string next_node;
-        int min_distance = INF;
+    while (path.size() < visited.size()) {
+        int next_node = -1;
+        double min_distance = numeric_limits<double>::infinity();
 
-        Vertex* node = network_.findVertex(current_node);
-        if (node != nullptr) {
-            for (const auto& edge : node->getAdj()) {
-                std::string neighbor = edge->getDest()->getInfo();
-                int weight = edge->getWeight();
+        for (unsigned e = csr.edgesBegin(current_node); e < csr.edgesEnd(current_node); e++) {
+            int neighbor = csr.getTarget(e);
+            double weight = csr.getWeight(e);
 
-                if (visited.find(neighbor) == visited.end() && weight < min_distance) {
-                    min_distance = weight;
-                    next_node = neighbor;
-                }
+            if (!visited[neighbor] && weight < min_distance) {
+                min_distance = weight;
+                next_node = neighbor;
             }
         }
 
-
-        if (next_node.empty()) {
+        if (next_node == -1) {
             return {};
         }
 
-        visited.insert(next_node);
+        visited[next_node] = true;
         path.push_back(next_node);
         current_node = next_node;
     }
 
-    path.push_back(start);
-    return path;
+    std::vector<std::string> tour;
+    tour.reserve(path.size() + 1);
+    for (int id : path) {
+        tour.push_back(network_.getVertex(id)->getInfo());
+    }
+    tour.push_back(start);
+    return tour;
 }
 
 
@@ -878,6 +2400,10 @@ std::vector<std::string> Data::tsp_real_world1(std::string start) {
 void Data::removeVertex(string id) {
     if(network_.findVertex(id) != nullptr) {
         network_.removeVertex(id);
+        freezeNetwork();
+        // The network no longer matches its snapshot, nor any closure computed from it.
+        snapshot_.clear();
+        closure_.clear();
     }
     else {
         cerr << "Vertex not found in the graph.\n";
@@ -896,6 +2422,10 @@ void Data::removeVertex(string id) {
 void Data::removeEdge(string id1, string id2) {
     if(network_.findVertex(id1) != nullptr && network_.findVertex(id2) != nullptr) {
         network_.removeEdge(id1, id2);
+        freezeNetwork();
+        // The network no longer matches its snapshot, nor any closure computed from it.
+        snapshot_.clear();
+        closure_.clear();
     }
     else {
         cerr << "One or both vertices not found in the graph.\n";
@@ -915,105 +2445,106 @@ void Data::removeEdge(string id1, string id2) {
  */
 bool Data::isConnected(const std::string& start) {
     if (network_.getVertexSet().empty()) return false;
-
-    std::unordered_set<std::string> visited;
-    std::queue<std::string> q;
-    q.push(start);
-    visited.insert(start);
-
-    while (!q.empty()) {
-        std::string node = q.front();
-        q.pop();
-
-        Vertex* vertex = network_.findVertex(node);
-        if (vertex != nullptr) {
-            for (const auto& edge : vertex->getAdj()) {
-                std::string neighbor = edge->getDest()->getInfo();
-                if (visited.find(neighbor) == visited.end()) {
-                    visited.insert(neighbor);
-                    q.push(neighbor);
-                }
+    int source = network_.findVertexIdx(start);
+    if (source == -1) return false;
+
+    const CSRGraph& csr = network_.getCSR();
+    std::vector<bool> visited(csr.getNumVertex(), false);
+    std::vector<int> q;
+    q.reserve(csr.getNumVertex());
+    q.push_back(source);
+    visited[source] = true;
+
+    for (size_t head = 0; head < q.size(); head++) {
+        int node = q[head];
+        for (unsigned e = csr.edgesBegin(node); e < csr.edgesEnd(node); e++) {
+            int neighbor = csr.getTarget(e);
+            if (!visited[neighbor]) {
+                visited[neighbor] = true;
+                q.push_back(neighbor);
             }
         }
     }
 
-    return visited.size() == network_.getVertexSet().size();
+    return q.size() == visited.size();
 }
 
 
 
+/**
+ * Number of cheapest neighbours of each vertex the local search tries as new endpoints.
+ */
+static const int LOCAL_SEARCH_NEIGHBOURS = 10;
+
 /**
  * @brief Optimizes a given TSP tour using the two-opt algorithm.
  *
  * @param tour The initial tour path.
  * @return std::vector<std::string> The optimized tour path.
  *
- * @complexity O(N^2 * E) where N is the number of nodes and E is the number of edges.
+ * @complexity O(k) per evaluated move and O(N) per applied move, where k is LOCAL_SEARCH_NEIGHBOURS.
  */
 
 std::vector<std::string> Data::twoOpt(const std::vector<std::string>& tour) {
-    auto calculateTourCost = [&](const std::vector<std::string>& t) {
-        int cost = 0;
-        for (size_t i = 0; i < t.size() - 1; ++i) {
-            Vertex* v1 = network_.findVertex(t[i]);
-            Vertex* v2 = network_.findVertex(t[i + 1]);
-            if (v1 && v2) {
-                for (const auto& edge : v1->getAdj()) {
-                    if (edge->getDest()->getInfo() == v2->getInfo()) {
-                        cost += edge->getWeight();
-                        break;
-                    }
-                }
-            } else {
-                return std::numeric_limits<int>::max();
-            }
+    if (tour.size() < 4) {
+        return tour;
+    }
+    std::vector<int> ids;
+    for (const auto& id : tour) {
+        Vertex* v = network_.findVertex(id);
+        if (v == nullptr) {
+            return tour;
         }
-        return cost;
-    };
-
-    std::vector<std::string> bestTour = tour;
-    int bestCost = calculateTourCost(bestTour);
+        ids.push_back(v->getId());
+    }
 
-    bool improvement = true;
-    int iteration = 0;
-    int noImprovementCount = 0;
-    const int maxNoImprovement = 100;
+    LocalSearch search(network_, LOCAL_SEARCH_NEIGHBOURS);
+    search.setMoves(true, false);
+    search.optimize(ids);
 
-    while (improvement && noImprovementCount < maxNoImprovement) {
-        improvement = false;
+    std::vector<std::string> result;
+    for (int id : ids) {
+        result.push_back(network_.getVertex(id)->getInfo());
+    }
+    return result;
+}
 
-        for (size_t i = 1; i < bestTour.size() - 1; ++i) {
-            for (size_t j = i + 2; j < bestTour.size(); ++j) {
-                std::vector<std::string> newTour = bestTour;
-                std::reverse(newTour.begin() + i, newTour.begin() + j);
 
-                int newCost = calculateTourCost(newTour);
+/**
+ * @brief Improves a tour found by any of the heuristics with 2-opt and Or-opt moves.
+ *
+ * @param tour The tour (first vertex == last vertex). Replaced by the improved tour, with the same start.
+ * @return double The cost of the improved tour.
+ *
+ * @complexity O(k) per evaluated move and O(N) per applied move, where k is LOCAL_SEARCH_NEIGHBOURS.
+ */
+double Data::improveTour(std::vector<Vertex*>& tour) {
+    if (tour.size() < 2) {
+        return 0;
+    }
+    std::vector<int> ids;
+    for (auto v : tour) {
+        ids.push_back(v->getId());
+    }
 
-                if (newCost < bestCost) {
-                    bestTour = newTour;
-                    bestCost = newCost;
-                    improvement = true;
-                    noImprovementCount = 0;
-                }
-            }
-        }
+    LocalSearch search(network_, LOCAL_SEARCH_NEIGHBOURS);
+    double cost = search.optimize(ids);
 
-        iteration++;
-        noImprovementCount++;
+    for (size_t i = 0; i < ids.size(); i++) {
+        tour[i] = network_.getVertex(ids[i]);
     }
-
-    return bestTour;
+    return cost;
 }
 
 
 
 /**
- * @brief Solves the TSP using a hybrid approach for real-world graphs, combining heuristic approach and two-opt heuristic.
+ * @brief Solves the TSP using a hybrid approach for real-world graphs, combining heuristic approach and local search (2-opt and Or-opt).
  *
  * @param start The starting node ID.
  * @return std::vector<std::string> The optimized tour path.
  *
- * @complexity O((V + E) log V + N^2 * E) where V is the number of vertices, E is the number of edges, and N is the number of nodes in the tour.
+ * @complexity O((V + E) log V) for the initial tour, plus O(N) per local search move, where N is the number of nodes in the tour.
  */
 std::vector<std::string> Data::tsp_real_world2(const std::string start) {
 
@@ -1021,11 +2552,235 @@ std::vector<std::string> Data::tsp_real_world2(const std::string start) {
         return {};
     }
     std::vector<std::string> tour = tsp_real_world1(start);
-    std::vector<std::string> optimizedTour = twoOpt(tour);
+    if (tour.empty()) {
+        return tour;
+    }
+
+    std::vector<Vertex*> optimizedTour;
+    for (const auto& id : tour) {
+        optimizedTour.push_back(network_.findVertex(id));
+    }
+    improveTour(optimizedTour);
+
+    std::vector<std::string> result;
+    for (auto v : optimizedTour) {
+        result.push_back(v->getInfo());
+    }
+    return result;
+}
+
+
+/**
+ * @brief Solves the TSP for real-world graphs with chained Lin-Kernighan, starting from the heuristic tour.
+ *
+ * The cost of the tour is available afterwards through getLinKernighanTourCost, and the best cost found
+ * over time through getLinKernighanProgress.
+ *
+ * @param start The starting node ID.
+ * @param timeLimit The time budget for the kicks, in seconds.
+ * @return std::vector<std::string> The best tour found, or an empty vector if there is none.
+ *
+ * @complexity O((V + E) log V) for the initial tour, plus the time budget.
+ */
+std::vector<std::string> Data::linKernighanTSP(const std::string& start, double timeLimit) {
+    lk_progress_.clear();
+    lk_tourCost_ = 0;
+    std::vector<std::string> tour = tsp_real_world1(start);
+    if (tour.empty()) {
+        return tour;
+    }
+
+    std::vector<int> ids;
+    for (const auto& id : tour) {
+        ids.push_back(network_.findVertexIdx(id));
+    }
+    LinKernighan solver(network_, LOCAL_SEARCH_NEIGHBOURS);
+    lk_tourCost_ = solver.solve(ids, timeLimit);
+    lk_progress_ = solver.getProgress();
+
+    std::vector<std::string> result;
+    for (int id : ids) {
+        result.push_back(network_.getVertex(id)->getInfo());
+    }
+    return result;
+}
+
+/**
+ * @brief Gets the best cost over time of the last Lin-Kernighan run.
+ *
+ * @return Pairs of (seconds since the start of the search, best cost so far).
+ *
+ * @complexity Time Complexity: O(1)
+ */
+const std::vector<std::pair<double, double>>& Data::getLinKernighanProgress() const {
+    return lk_progress_;
+}
+
+/**
+ * @brief Gets the cost of the last tour found by linKernighanTSP, in the exact (double) edge weights.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+double Data::getLinKernighanTourCost() const {
+    return lk_tourCost_;
+}
+
+
 
-    return optimizedTour;
+
+/**
+ * @brief Computes the shortest-path metric closure over a subset of the vertices (see MetricClosure).
+ *
+ * Rows are computed by parallel Dijkstra runs. When the network was loaded through a snapshot, the
+ * closure is cached next to it (snapshot + ".closure") and reused while the snapshot and the subset are
+ * the same; removing vertices or edges drops both.
+ *
+ * @param subset The ids of the vertices of the closure, or empty for all vertices.
+ * @param threads The number of worker threads.
+ * @return bool True on success, false if a vertex of the subset is not in the network.
+ *
+ * @complexity O(K (V + E) log V / T) where K is the size of the subset and T the number of threads, or O(K^2) from the cache.
+ */
+bool Data::buildMetricClosure(const std::vector<std::string>& subset, unsigned threads) {
+    std::vector<int> vertices;
+    if (subset.empty()) {
+        for (int v = 0; v < network_.getNumVertex(); v++) {
+            vertices.push_back(v);
+        }
+    }
+    for (const auto& id : subset) {
+        int v = network_.findVertexIdx(id);
+        if (v == -1) {
+            return false;
+        }
+        if (find(vertices.begin(), vertices.end(), v) == vertices.end()) {
+            vertices.push_back(v);
+        }
+    }
+    if (closure_.getVertices() == vertices && !closure_.empty()) {
+        return true;
+    }
+
+    SourceFingerprint print = {};
+    bool cached = !snapshot_.empty() && fingerprint(snapshot_, print);
+    const uint64_t key = print.size ^ ((uint64_t) print.modified * 0x9E3779B97F4A7C15ULL);
+    const string cache = snapshot_ + ".closure";
+    if (cached && closure_.load(cache, key, vertices)) {
+        return true;
+    }
+    closure_.build(network_.getCSR(), vertices, threads);
+    if (cached) {
+        closure_.save(cache, key);
+    }
+    return true;
+}
+
+/**
+ * @brief Gets the metric closure computed by the last call to buildMetricClosure.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+const MetricClosure& Data::getMetricClosure() const {
+    return closure_;
+}
+
+/**
+ * @brief Solves the TSP on a sparse graph by running the complete-graph heuristics on its metric closure.
+ *
+ * The closure over all vertices turns every pair into an edge whose weight is the shortest path between
+ * them, so a nearest-neighbour tour never gets stuck while the graph is connected; the tour is then
+ * improved with 2-opt and Or-opt. Consecutive vertices of the result may not be adjacent in the network:
+ * expandMetricClosureTour gives the actual walk, whose length is getMetricClosureTourCost.
+ *
+ * @param start The starting node ID.
+ * @param threads The number of threads used to compute the closure.
+ * @return std::vector<std::string> The tour, or an empty vector if some vertex cannot be reached.
+ *
+ * @complexity O(V (V + E) log V / T) for the closure, O(V^2) for the tour, plus O(N) per local search move.
+ */
+std::vector<std::string> Data::metricClosureTSP(const std::string& start, unsigned threads) {
+    closure_tourCost_ = 0;
+    int source = network_.findVertexIdx(start);
+    if (source == -1 || !buildMetricClosure({}, threads)) {
+        return {};
+    }
+
+    const int n = closure_.size();
+    const DistanceMatrix& dist = closure_.getMatrix();
+    std::vector<bool> visited(n, false);
+    std::vector<int> ids = {source};
+    visited[source] = true;
+    while ((int) ids.size() < n) {
+        const double* row = dist.row(ids.back());
+        int next = -1;
+        for (int v = 0; v < n; v++) {
+            if (!visited[v] && (next == -1 || row[v] < row[next])) {
+                next = v;
+            }
+        }
+        if (row[next] == numeric_limits<double>::infinity()) {
+            return {};
+        }
+        visited[next] = true;
+        ids.push_back(next);
+    }
+    ids.push_back(source);
+
+    Graph complete = closure_.toGraph(network_, LOCAL_SEARCH_NEIGHBOURS);
+    LocalSearch search(complete, LOCAL_SEARCH_NEIGHBOURS);
+    closure_tourCost_ = search.optimize(ids);
+
+    std::vector<std::string> tour;
+    for (int id : ids) {
+        tour.push_back(network_.getVertex(closure_.getVertex(id))->getInfo());
+    }
+    return tour;
+}
+
+/**
+ * @brief Gets the cost of the last tour found by metricClosureTSP (the length of its walk in the network).
+ *
+ * @complexity Time Complexity: O(1)
+ */
+double Data::getMetricClosureTourCost() const {
+    return closure_tourCost_;
 }
 
+/**
+ * @brief Turns a tour over the metric closure into a walk in the network.
+ *
+ * Every step between vertices that are not adjacent is replaced by a shortest path between them,
+ * so vertices may appear more than once in the walk.
+ *
+ * @param tour The tour, as node IDs.
+ * @return std::vector<std::string> The walk, or an empty vector if some step has no path.
+ *
+ * @complexity O(N (V + E) log V) in the worst case, usually far less thanks to early exit.
+ */
+std::vector<std::string> Data::expandMetricClosureTour(const std::vector<std::string>& tour) const {
+    std::vector<std::string> walk;
+    if (tour.empty()) {
+        return walk;
+    }
+    ShortestPaths& paths = shortestPaths();
+    walk.push_back(tour.front());
+    for (size_t i = 0; i + 1 < tour.size(); i++) {
+        int from = network_.findVertexIdx(tour[i]);
+        int to = network_.findVertexIdx(tour[i + 1]);
+        if (from == -1 || to == -1) {
+            return {};
+        }
+        paths.run({from}, {to});
+        std::vector<int> path = paths.getPath(to);
+        if (path.empty()) {
+            return {};
+        }
+        for (size_t j = 1; j < path.size(); j++) {
+            walk.push_back(network_.getVertex(path[j])->getInfo());
+        }
+    }
+    return walk;
+}
 
 
 
@@ -1046,4 +2801,19 @@ Não é eficiente para grafos grandes.
 
  */
 
-
+/**
+ * @brief Precomputes the candidate neighbour lists of the network (see CandidateLists).
+ *
+ * Quadrant neighbours are included for vertices with coordinates. Until the network changes, the nearest
+ * neighbour searches of the construction heuristics try the lists first and local search and Lin-Kernighan
+ * take their neighbour lists from them.
+ *
+ * @param k The number of cheapest neighbours kept per vertex.
+ * @return The lists, with their build time.
+ *
+ * @complexity O(V + E log D) where D is the maximum degree.
+ */
+const CandidateLists& Data::buildCandidateLists(int k) {
+    network_.buildCandidates(k, true);
+    return network_.getCandidates();
+}
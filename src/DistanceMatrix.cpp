@@ -0,0 +1,61 @@
+#include "../headerFiles/DistanceMatrix.h"
+
+/**
+ * @brief Constructs an empty matrix.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+DistanceMatrix::DistanceMatrix() : n(0), triangular(false), stride(0) {}
+
+/**
+ * @brief Constructs an n x n matrix with every entry set to fill.
+ *
+ * @param n The number of rows and columns.
+ * @param triangular True to store only the upper triangle (for symmetric weights).
+ * @param fill The initial value of every entry.
+ *
+ * @complexity Time Complexity: O(n^2)
+ */
+DistanceMatrix::DistanceMatrix(int n, bool triangular, double fill) : n(n), triangular(triangular) {
+    const std::size_t perLine = 64 / sizeof(double);
+    if (triangular) {
+        stride = 0;
+        rowStart.resize(n);
+        std::size_t offset = 0;
+        for (int i = 0; i < n; i++) {
+            rowStart[i] = offset - i;
+            offset += n - i;
+        }
+        data.assign(offset, fill);
+    }
+    else {
+        stride = (n + perLine - 1) / perLine * perLine;
+        data.assign(stride * n, fill);
+    }
+}
+
+/**
+ * @brief Gets a whole row of the matrix, for the full layout only.
+ *
+ * @param i The row.
+ *
+ * @return Pointer to the first of the n entries of row i, aligned to a cache line.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+const double* DistanceMatrix::row(int i) const {
+    return data.data() + (std::size_t) i * stride;
+}
+
+/**
+ * @brief Releases the matrix, leaving it empty.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+void DistanceMatrix::clear() {
+    n = 0;
+    stride = 0;
+    rowStart.clear();
+    data.clear();
+    data.shrink_to_fit();
+}
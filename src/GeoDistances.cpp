@@ -0,0 +1,68 @@
+#include "../headerFiles/GeoDistances.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+/**
+ * @brief Makes room for n vertices, none of them with coordinates yet.
+ *
+ * @complexity Time Complexity: O(n)
+ */
+void GeoDistances::reset(int n) {
+    const double none = std::numeric_limits<double>::quiet_NaN();
+    x.assign(n, none);
+    y.assign(n, none);
+    z.assign(n, none);
+}
+
+/**
+ * @brief Sets the coordinates of a vertex.
+ *
+ * @param v The vertex id.
+ * @param lat The latitude, in degrees.
+ * @param lon The longitude, in degrees.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+void GeoDistances::set(int v, double lat, double lon) {
+    lat *= M_PI / 180.0;
+    lon *= M_PI / 180.0;
+    x[v] = cos(lat) * cos(lon);
+    y[v] = cos(lat) * sin(lon);
+    z[v] = sin(lat);
+}
+
+/**
+ * @brief Releases all coordinates.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+void GeoDistances::clear() {
+    x.clear();
+    y.clear();
+    z.clear();
+}
+
+/**
+ * @brief Turns a squared chord of the unit sphere into a great-circle distance in metres.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+static double chordToMetres(double chordSquared) {
+    return 2 * GeoDistances::EARTH_RADIUS * std::asin(std::min(1.0, std::sqrt(chordSquared) / 2));
+}
+
+/**
+ * @brief Gets the haversine distance between two vertices.
+ *
+ * @return The distance in metres, or infinity if one of them has no coordinates.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+double GeoDistances::distance(int u, int v) const {
+    if (!hasCoord(u) || !hasCoord(v)) {
+        return std::numeric_limits<double>::infinity();
+    }
+    double dx = x[u] - x[v], dy = y[u] - y[v], dz = z[u] - z[v];
+    return chordToMetres(dx * dx + dy * dy + dz * dz);
+}
@@ -1,7 +1,9 @@
 
 #include "../headerFiles//Graph.h"
+#include <type_traits>
+#include <chrono>
 
-Vertex::Vertex(const std::string& in, const double& longitude_, const double& latitude_, bool f_) : hascoor(f_), longitude(longitude_), latitude(latitude_), info(in), visited(false), processing(false), indegree(0), dist(0), path(nullptr), queueIndex(0) {}
+Vertex::Vertex(const std::string& in, const double& longitude_, const double& latitude_, bool f_) : id(-1), hascoor(f_), longitude(longitude_), latitude(latitude_), info(in) {}
 
 /**
  * @brief Adds an edge from this vertex to the destination vertex with the given weight.
@@ -14,7 +16,7 @@ Vertex::Vertex(const std::string& in, const double& longitude_, const double& la
  * @complexity Time Complexity: O(1)
  */
 Edge* Vertex::addEdge(Vertex* d, double w) {
-    auto newEdge = new Edge(this, d, w);
+    auto newEdge = edgePool != nullptr ? edgePool->create(this, d, w) : new Edge(this, d, w);
     adj.push_back(newEdge);
     d->incoming.push_back(newEdge);
     return newEdge;
@@ -62,16 +64,14 @@ void Vertex::removeOutgoingEdges() {
 }
 
 /**
- * @brief Overloaded less than operator for comparing vertices based on their distance.
+ * @brief Gets the id of this vertex, i.e. its position in the graph's vertex set.
  *
- * @param vertex The vertex to compare with.
- *
- * @return True if this vertex's distance is less than the other vertex's distance, false otherwise.
+ * @return The id of this vertex.
  *
  * @complexity Time Complexity: O(1)
  */
-bool Vertex::operator<(const Vertex& vertex) const {
-    return this->dist < vertex.dist;
+int Vertex::getId() const {
+    return this->id;
 }
 
 /**
@@ -81,7 +81,7 @@ bool Vertex::operator<(const Vertex& vertex) const {
  *
  * @complexity Time Complexity: O(1)
  */
-std::string Vertex::getInfo() const {
+const std::string& Vertex::getInfo() const {
     return this->info;
 }
 
@@ -92,74 +92,30 @@ std::string Vertex::getInfo() const {
  *
  * @complexity Time Complexity: O(1)
  */
-std::vector<Edge*> Vertex::getAdj() const {
+const std::vector<Edge*>& Vertex::getAdj() const {
     return this->adj;
 }
 
 /**
- * @brief Checks if this vertex has been visited.
- *
- * @return True if this vertex has been visited, false otherwise.
- *
- * @complexity Time Complexity: O(1)
- */
-bool Vertex::isVisited() const {
-    return this->visited;
-}
-
-/**
- * @brief Checks if this vertex is currently being processed.
- *
- * @return True if this vertex is currently being processed, false otherwise.
- *
- * @complexity Time Complexity: O(1)
- */
-bool Vertex::isProcessing() const {
-    return this->processing;
-}
-
-/**
- * @brief Gets the indegree of this vertex.
- *
- * @return The indegree of this vertex.
- *
- * @complexity Time Complexity: O(1)
- */
-unsigned int Vertex::getIndegree() const {
-    return this->indegree;
-}
-
-/**
- * @brief Gets the distance of this vertex.
- *
- * @return The distance of this vertex.
- *
- * @complexity Time Complexity: O(1)
- */
-double Vertex::getDist() const {
-    return this->dist;
-}
-
-/**
- * @brief Gets the path stored in this vertex.
+ * @brief Gets the incoming edges of this vertex.
  *
- * @return The path stored in this vertex.
+ * @return The incoming edges of this vertex.
  *
  * @complexity Time Complexity: O(1)
  */
-Edge* Vertex::getPath() const {
-    return this->path;
+const std::vector<Edge*>& Vertex::getIncoming() const {
+    return this->incoming;
 }
 
 /**
- * @brief Gets the incoming edges of this vertex.
+ * @brief Sets the id of this vertex.
  *
- * @return The incoming edges of this vertex.
+ * @param id The id to set.
  *
  * @complexity Time Complexity: O(1)
  */
-std::vector<Edge*> Vertex::getIncoming() const {
-    return this->incoming;
+void Vertex::setId(int id) {
+    this->id = id;
 }
 
 /**
@@ -174,85 +130,6 @@ void Vertex::setInfo(const std::string& info) {
 }
 
 
-/**
- * @brief Sets the visited status of this vertex.
- *
- * @param visited The visited status to set.
- *
- * @complexity Time Complexity: O(1)
- */
-void Vertex::setVisited(bool visited) {
-    this->visited = visited;
-}
-
-/**
- * @brief Sets the processing status of this vertex.
- *
- * @param processing The processing status to set.
- *
- * @complexity Time Complexity: O(1)
- */
-void Vertex::setProcessing(bool processing) {
-    this->processing = processing;
-}
-
-/**
- * @brief Sets the indegree of this vertex.
- *
- * @param indegree The indegree to set.
- *
- * @complexity Time Complexity: O(1)
- */
-void Vertex::setIndegree(unsigned int indegree) {
-    this->indegree = indegree;
-}
-
-/**
- * @brief Sets the parent of this vertex.
- *
- * @param parent The parent to set.
- *
- * @complexity Time Complexity: O(1)
- */
-void Vertex::setParent(Vertex* parent) {
-    this->parent_ = parent;
-}
-
-/**
- * @brief Gets the parent of this vertex.
- *
- * @return The parent of this vertex.
- *
- * @complexity Time Complexity: O(1)
- */
-Vertex* Vertex::getParent() const {
-    return parent_;
-}
-
-
-/**
- * @brief Sets the distance of this vertex.
- *
- * @param dist The distance to set.
- *
- * @complexity Time Complexity: O(1)
- */
-void Vertex::setDist(double dist) {
-    this->dist = dist;
-}
-
-/**
- * @brief Sets the path stored in this vertex.
- *
- * @param path The path to set.
- *
- * @complexity Time Complexity: O(1)
- */
-void Vertex::setPath(Edge* path) {
-    this->path = path;
-}
-
-
 /**
  * @brief Deletes the given edge from the incoming edges of its destination vertex.
  *
@@ -271,7 +148,12 @@ void Vertex::deleteEdge(Edge* edge) {
             it++;
         }
     }
-    delete edge;
+    if (edgePool != nullptr) {
+        edgePool->destroy(edge);
+    }
+    else {
+        delete edge;
+    }
 }
 
 double Vertex::getLong() const {
@@ -393,6 +275,79 @@ void Edge::setFlow(double flow) {
 }
 
 
+/**
+ * @brief Constructs an empty graph.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+Graph::Graph() : pathMatrix(nullptr), vertexPool(std::make_unique<ObjectPool<Vertex>>()),
+        edgePool(std::make_unique<ObjectPool<Edge>>()) {}
+
+/**
+ * @brief Destroys the graph, releasing all of its vertices and edges.
+ *
+ * Edges are trivially destructible, so they are released together with the pool's blocks instead of one by one.
+ *
+ * @complexity Time Complexity: O(V + B), where V is the number of vertices and B the number of pool blocks.
+ */
+Graph::~Graph() {
+    destroyVertices();
+}
+
+/**
+ * @brief Moves a graph. Vertices and edges are not copied; the other graph is left empty.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+Graph::Graph(Graph&& other) noexcept : vertexSet(std::move(other.vertexSet)), vertexMap(std::move(other.vertexMap)),
+        csr(std::move(other.csr)), frozen(other.frozen), distMatrix(std::move(other.distMatrix)),
+        pathMatrix(other.pathMatrix), candidates(std::move(other.candidates)), geo(std::move(other.geo)),
+        vertexPool(std::move(other.vertexPool)), edgePool(std::move(other.edgePool)) {
+    other.vertexSet.clear();
+    other.vertexMap.clear();
+    other.frozen = false;
+    other.pathMatrix = nullptr;
+}
+
+/**
+ * @brief Replaces this graph by another one, releasing the current vertices and edges.
+ *
+ * @complexity Time Complexity: O(V + B) to release the current graph.
+ */
+Graph& Graph::operator=(Graph&& other) noexcept {
+    if (this != &other) {
+        destroyVertices();
+        vertexSet = std::move(other.vertexSet);
+        vertexMap = std::move(other.vertexMap);
+        csr = std::move(other.csr);
+        frozen = other.frozen;
+        distMatrix = std::move(other.distMatrix);
+        pathMatrix = other.pathMatrix;
+        candidates = std::move(other.candidates);
+        geo = std::move(other.geo);
+        vertexPool = std::move(other.vertexPool);
+        edgePool = std::move(other.edgePool);
+        other.vertexSet.clear();
+        other.vertexMap.clear();
+        other.frozen = false;
+        other.pathMatrix = nullptr;
+    }
+    return *this;
+}
+
+/**
+ * @brief Runs the destructor of every vertex; the memory itself goes back with the pools.
+ *
+ * @complexity Time Complexity: O(V)
+ */
+void Graph::destroyVertices() {
+    static_assert(std::is_trivially_destructible<Edge>::value, "edges are released without running destructors");
+    for (auto v : vertexSet) {
+        vertexPool->destroy(v);
+    }
+    vertexSet.clear();
+}
+
 /**
  * @brief Finds a vertex in the graph given its information.
  *
@@ -424,9 +379,16 @@ bool Graph::addVertex(const std::string& in, const double& longitude, const doub
     if (findVertex(in) != nullptr) {
         return false;
     }
-    Vertex* vertex = new Vertex(in, longitude, latitude, f);
+    if (vertexPool == nullptr) {
+        vertexPool = std::make_unique<ObjectPool<Vertex>>();
+        edgePool = std::make_unique<ObjectPool<Edge>>();
+    }
+    Vertex* vertex = vertexPool->create(in, longitude, latitude, f);
+    vertex->edgePool = edgePool.get();
+    vertex->setId(vertexSet.size());
     vertexSet.push_back(vertex);
     vertexMap[in] = vertex;
+    frozen = false;
     return true;
 }
 
@@ -454,8 +416,12 @@ bool Graph::removeVertex(const std::string& in) {
         }
     }
     vertexSet.erase(std::remove(vertexSet.begin(), vertexSet.end(), v), vertexSet.end());
+    for (unsigned i = v->getId(); i < vertexSet.size(); i++) {
+        vertexSet[i]->setId(i);
+    }
     vertexMap.erase(it);
-    delete v;
+    vertexPool->destroy(v);
+    frozen = false;
     // Após remover o vértice, atualize o fluxo residual das arestas
 
     return true;
@@ -479,6 +445,7 @@ bool Graph::addEdge(const std::string& source, const std::string& dest, double w
         return false;
     }
     v1->addEdge(v2, w);
+    frozen = false;
     return true;
 }
 
@@ -497,6 +464,7 @@ bool Graph::removeEdge(const std::string& source, const std::string& dest) {
     if (srcVertex == nullptr) {
         return false;
     }
+    frozen = false;
     return srcVertex->removeEdge(dest);
 }
 
@@ -521,9 +489,45 @@ bool Graph::addBidirectionalEdge(const std::string& source, const std::string& d
     Edge* e2 = v2->addEdge(v1, w);
     e1->setReverse(e2);
     e2->setReverse(e1);
+    frozen = false;
     return true;
 }
 
+/**
+ * @brief Adds many edges at once, given by vertex id.
+ *
+ * The adjacency and incoming lists are grown once to their final size, so large files do not pay for
+ * repeated reallocation. Edges are appended in the order given, the same order addEdge would produce.
+ *
+ * @param edges The edges; both ids must be valid.
+ * @param bothWays True to also add, right after each edge, the edge in the opposite direction with the same weight.
+ *
+ * @complexity Time Complexity: O(V + E), where E is the number of edges added.
+ */
+void Graph::addEdges(const std::vector<EdgeRecord>& edges, bool bothWays) {
+    std::vector<unsigned> outgoing(vertexSet.size(), 0);
+    std::vector<unsigned> arriving(vertexSet.size(), 0);
+    for (const auto& e : edges) {
+        outgoing[e.source]++;
+        arriving[e.dest]++;
+        if (bothWays) {
+            outgoing[e.dest]++;
+            arriving[e.source]++;
+        }
+    }
+    for (size_t i = 0; i < vertexSet.size(); i++) {
+        vertexSet[i]->adj.reserve(vertexSet[i]->adj.size() + outgoing[i]);
+        vertexSet[i]->incoming.reserve(vertexSet[i]->incoming.size() + arriving[i]);
+    }
+    for (const auto& e : edges) {
+        vertexSet[e.source]->addEdge(vertexSet[e.dest], e.weight);
+        if (bothWays) {
+            vertexSet[e.dest]->addEdge(vertexSet[e.source], e.weight);
+        }
+    }
+    frozen = false;
+}
+
 /**
  * @brief Gets the number of vertices in the graph.
  *
@@ -535,6 +539,19 @@ int Graph::getNumVertex() const {
     return vertexSet.size();
 }
 
+/**
+ * @brief Gets a vertex given its id.
+ *
+ * @param id The id of the vertex, between 0 and getNumVertex() - 1.
+ *
+ * @return Pointer to the vertex.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+Vertex* Graph::getVertex(int id) const {
+    return vertexSet[id];
+}
+
 /**
  * @brief Gets the vector containing all vertices in the graph.
  *
@@ -542,7 +559,7 @@ int Graph::getNumVertex() const {
  *
  * @complexity Time Complexity: O(1)
  */
-std::vector<Vertex*> Graph::getVertexSet() const {
+const std::vector<Vertex*>& Graph::getVertexSet() const {
     return vertexSet;
 }
 
@@ -553,10 +570,38 @@ std::vector<Vertex*> Graph::getVertexSet() const {
  *
  * @complexity Time Complexity: O(1)
  */
-std::unordered_map<std::string, Vertex*> Graph::getVertexMap() const {
+const std::unordered_map<std::string, Vertex*>& Graph::getVertexMap() const {
     return vertexMap;
 }
 
+/**
+ * @brief Sizes the marks for n vertices and clears them.
+ *
+ * @param n The number of vertices.
+ *
+ * @complexity Time Complexity: O(n / 64)
+ */
+void TraversalScratch::reset(int n) {
+    visited.assign((n + 63) / 64, 0);
+    processing.assign((n + 63) / 64, 0);
+    stack.clear();
+    queue.clear();
+}
+
+/**
+ * @brief Sizes the workspace for n vertices: none visited, infinite distances, no paths or parents.
+ *
+ * @param n The number of vertices.
+ *
+ * @complexity Time Complexity: O(n)
+ */
+void Workspace::reset(int n) {
+    visited.assign(n, false);
+    dist.assign(n, std::numeric_limits<double>::infinity());
+    path.assign(n, nullptr);
+    parents.assign(n, -1);
+}
+
 /**
  * @brief Performs a depth-first search (DFS) traversal of the graph.
  *
@@ -565,15 +610,20 @@ std::unordered_map<std::string, Vertex*> Graph::getVertexMap() const {
  * @complexity Time Complexity: O(V + E), where V is the number of vertices and E is the number of edges in the graph.
  */
 std::vector<std::string> Graph::dfs() const {
-    std::vector<std::string> res;
-    for (auto v : vertexSet) {
-        v->setVisited(false);
-    }
+    TraversalScratch scratch;
+    scratch.reset(getNumVertex());
+    std::vector<int> order;
+    order.reserve(vertexSet.size());
     for (auto v : vertexSet) {
-        if (!v->isVisited()) {
-            dfsVisit(v, res);
+        if (!scratch.isVisited(v->getId())) {
+            dfsVisit(v->getId(), scratch, order);
         }
     }
+    std::vector<std::string> res;
+    res.reserve(order.size());
+    for (int id : order) {
+        res.push_back(vertexSet[id]->getInfo());
+    }
     return res;
 }
 
@@ -588,32 +638,50 @@ std::vector<std::string> Graph::dfs() const {
  */
 std::vector<std::string> Graph::dfs(const std::string& source) const {
     std::vector<std::string> res;
-    Vertex* s = findVertex(source);
-    if (s == nullptr) {
+    int s = findVertexIdx(source);
+    if (s == -1) {
         return res;
     }
-    for (auto v : vertexSet) {
-        v->setVisited(false);
+    TraversalScratch scratch;
+    scratch.reset(getNumVertex());
+    std::vector<int> order;
+    dfsVisit(s, scratch, order);
+    res.reserve(order.size());
+    for (int id : order) {
+        res.push_back(vertexSet[id]->getInfo());
     }
-    dfsVisit(s, res);
     return res;
 }
 
 /**
- * @brief Helper function for depth-first search (DFS) traversal.
+ * @brief Helper function for depth-first search (DFS) traversal, with an explicit stack.
+ *
+ * Visits, in preorder, every vertex reachable from v that the scratch does not mark as visited, following
+ * the adjacency lists in order (the same order as the recursive version).
  *
- * @param v Pointer to the vertex to start the DFS traversal.
- * @param res Vector to store the information of the vertices visited during the DFS traversal.
+ * @param v The id of the vertex to start the DFS traversal.
+ * @param scratch The marks and stack, sized by TraversalScratch::reset.
+ * @param order Receives the ids of the vertices visited, appended.
  *
  * @complexity Time Complexity: O(V + E), where V is the number of vertices and E is the number of edges in the graph.
  */
-void Graph::dfsVisit(Vertex* v, std::vector<std::string>& res) const {
-    v->setVisited(true);
-    res.push_back(v->getInfo());
-    for (auto& e : v->getAdj()) {
-        Vertex* w = e->getDest();
-        if (!w->isVisited()) {
-            dfsVisit(w, res);
+void Graph::dfsVisit(int v, TraversalScratch& scratch, std::vector<int>& order) const {
+    auto& stack = scratch.getStack();
+    scratch.setVisited(v);
+    order.push_back(v);
+    stack.push_back({v, 0});
+    while (!stack.empty()) {
+        auto& top = stack.back();
+        const auto& adj = vertexSet[top.first]->getAdj();
+        if (top.second == adj.size()) {
+            stack.pop_back();
+            continue;
+        }
+        int w = adj[top.second++]->getDest()->getId();
+        if (!scratch.isVisited(w)) {
+            scratch.setVisited(w);
+            order.push_back(w);
+            stack.push_back({w, 0});
         }
     }
 }
@@ -629,29 +697,48 @@ void Graph::dfsVisit(Vertex* v, std::vector<std::string>& res) const {
  */
 std::vector<std::string> Graph::bfs(const std::string& source) const {
     std::vector<std::string> res;
-    Vertex* s = findVertex(source);
-    if (s == nullptr) {
+    int s = findVertexIdx(source);
+    if (s == -1) {
         return res;
     }
-    for (auto v : vertexSet) {
-        v->setVisited(false);
-    }
-    std::queue<Vertex*> q;
-    q.push(s);
-    s->setVisited(true);
-    while (!q.empty()) {
-        Vertex* v = q.front();
-        q.pop();
-        res.push_back(v->getInfo());
-        for (auto& e : v->getAdj()) {
-            Vertex* w = e->getDest();
-            if (!w->isVisited()) {
-                q.push(w);
-                w->setVisited(true);
+    TraversalScratch scratch;
+    scratch.reset(getNumVertex());
+    std::vector<int> order;
+    bfsVisit(s, scratch, order);
+    res.reserve(order.size());
+    for (int id : order) {
+        res.push_back(vertexSet[id]->getInfo());
+    }
+    return res;
+}
+
+/**
+ * @brief Helper function for breadth-first search (BFS) traversal.
+ *
+ * Visits, by distance from v, every vertex reachable from v that the scratch does not mark as visited.
+ *
+ * @param v The id of the vertex to start the BFS traversal.
+ * @param scratch The marks and queue, sized by TraversalScratch::reset.
+ * @param order Receives the ids of the vertices visited, appended.
+ *
+ * @complexity Time Complexity: O(V + E), where V is the number of vertices and E is the number of edges in the graph.
+ */
+void Graph::bfsVisit(int v, TraversalScratch& scratch, std::vector<int>& order) const {
+    auto& queue = scratch.getQueue();
+    queue.clear();
+    queue.push_back(v);
+    scratch.setVisited(v);
+    for (size_t head = 0; head < queue.size(); head++) {
+        int u = queue[head];
+        order.push_back(u);
+        for (auto e : vertexSet[u]->getAdj()) {
+            int w = e->getDest()->getId();
+            if (!scratch.isVisited(w)) {
+                scratch.setVisited(w);
+                queue.push_back(w);
             }
         }
     }
-    return res;
 }
 
 /**
@@ -662,13 +749,11 @@ std::vector<std::string> Graph::bfs(const std::string& source) const {
  * @complexity Time Complexity: O(V + E), where V is the number of vertices and E is the number of edges in the graph.
  */
 bool Graph::isDAG() const {
+    TraversalScratch scratch;
+    scratch.reset(getNumVertex());
     for (auto v : vertexSet) {
-        v->setVisited(false);
-        v->setProcessing(false);
-    }
-    for (auto v : vertexSet) {
-        if (!v->isVisited()) {
-            if (!dfsIsDAG(v)) {
+        if (!scratch.isVisited(v->getId())) {
+            if (!dfsIsDAG(v->getId(), scratch)) {
                 return false;
             }
         }
@@ -679,27 +764,39 @@ bool Graph::isDAG() const {
 /**
  * @brief Helper function for checking if the graph is a directed acyclic graph (DAG) using depth-first search (DFS).
  *
- * @param v Pointer to the vertex to start the DFS traversal.
+ * Vertices on the current path are marked as processing; reaching one of them closes a cycle.
  *
- * @return True if the graph is a DAG, false otherwise.
+ * @param v The id of the vertex to start the DFS traversal.
+ * @param scratch The marks and stack, sized by TraversalScratch::reset.
+ *
+ * @return True if no cycle is reachable from v, false otherwise.
  *
  * @complexity Time Complexity: O(V + E), where V is the number of vertices and E is the number of edges in the graph.
  */
-bool Graph::dfsIsDAG(Vertex* v) const {
-    v->setVisited(true);
-    v->setProcessing(true);
-    for (auto e : v->getAdj()) {
-        Vertex* w = e->getDest();
-        if (w->isProcessing()) {
+bool Graph::dfsIsDAG(int v, TraversalScratch& scratch) const {
+    auto& stack = scratch.getStack();
+    scratch.setVisited(v);
+    scratch.setProcessing(v, true);
+    stack.push_back({v, 0});
+    while (!stack.empty()) {
+        auto& top = stack.back();
+        const auto& adj = vertexSet[top.first]->getAdj();
+        if (top.second == adj.size()) {
+            scratch.setProcessing(top.first, false);
+            stack.pop_back();
+            continue;
+        }
+        int w = adj[top.second++]->getDest()->getId();
+        if (scratch.isProcessing(w)) {
+            stack.clear();
             return false;
         }
-        if (!w->isVisited()) {
-            if (!dfsIsDAG(w)) {
-                return false;
-            }
+        if (!scratch.isVisited(w)) {
+            scratch.setVisited(w);
+            scratch.setProcessing(w, true);
+            stack.push_back({w, 0});
         }
     }
-    v->setProcessing(false);
     return true;
 }
 
@@ -712,30 +809,25 @@ bool Graph::dfsIsDAG(Vertex* v) const {
  */
 std::vector<std::string> Graph::topsort() const {
     std::vector<std::string> res;
-    for (auto v : vertexSet) {
-        v->setIndegree(0);
-    }
+    std::vector<unsigned> indegree(vertexSet.size(), 0);
     for (auto v : vertexSet) {
         for (auto e : v->getAdj()) {
-            unsigned int indegree = e->getDest()->getIndegree();
-            e->getDest()->setIndegree(indegree + 1);
+            indegree[e->getDest()->getId()]++;
         }
     }
-    std::queue<Vertex*> q;
+    std::vector<int> q;
     for (auto v : vertexSet) {
-        if (v->getIndegree() == 0) {
-            q.push(v);
+        if (indegree[v->getId()] == 0) {
+            q.push_back(v->getId());
         }
     }
-    while (!q.empty()) {
-        Vertex* v = q.front();
-        q.pop();
+    for (size_t head = 0; head < q.size(); head++) {
+        Vertex* v = vertexSet[q[head]];
         res.push_back(v->getInfo());
         for (auto e : v->getAdj()) {
-            Vertex* w = e->getDest();
-            w->setIndegree(w->getIndegree() - 1);
-            if (w->getIndegree() == 0) {
-                q.push(w);
+            int w = e->getDest()->getId();
+            if (--indegree[w] == 0) {
+                q.push_back(w);
             }
         }
     }
@@ -746,21 +838,19 @@ std::vector<std::string> Graph::topsort() const {
 }
 
 /**
- * @brief Finds the index of a vertex in the graph given its information.
+ * @brief Finds the id (index in the vertex set) of a vertex given its information.
+ *
+ * This is the only place where CSV ids are translated into the dense integer ids used by the algorithms.
  *
  * @param in The information of the vertex to find.
  *
- * @return The index of the vertex if found, -1 otherwise.
+ * @return The id of the vertex if found, -1 otherwise.
  *
- * @complexity Time Complexity: O(V), where V is the number of vertices in the graph.
+ * @complexity Time Complexity: O(1) on average.
  */
 int Graph::findVertexIdx(const std::string& in) const {
-    for (unsigned i = 0; i < vertexSet.size(); i++) {
-        if (vertexSet[i]->getInfo() == in) {
-            return i;
-        }
-    }
-    return -1;
+    Vertex* v = findVertex(in);
+    return v == nullptr ? -1 : v->getId();
 }
 
 /**
@@ -818,8 +908,12 @@ double Graph::getEdgeWeight(const std::string& source, const std::string& dest)
     if (srcVertex == nullptr) {
         return std::numeric_limits<double>::infinity();
     }
+    Vertex* destVertex = findVertex(dest);
+    if (destVertex == nullptr) {
+        return std::numeric_limits<double>::infinity();
+    }
     for (auto& e : srcVertex->getAdj()) {
-        if (e->getDest()->getInfo() == dest) {
+        if (e->getDest() == destVertex) {
             return e->getWeight();
         }
     }
@@ -835,5 +929,297 @@ void Vertex::setHasCoord(bool hasco) {
 }
 
 
+/**
+ * @brief Builds the compressed-sparse-row view of the graph (see CSRGraph).
+ *
+ * Must be called again after the graph changes; until then isFrozen() returns false.
+ * Candidate lists built for the previous view are dropped.
+ *
+ * @complexity Time Complexity: O(V + E), where V is the number of vertices and E is the number of edges in the graph.
+ */
+void Graph::freeze() {
+    csr.offsets.assign(1, 0);
+    csr.offsets.reserve(vertexSet.size() + 1);
+    csr.targets.clear();
+    csr.weights.clear();
+    for (auto v : vertexSet) {
+        for (auto e : v->getAdj()) {
+            csr.targets.push_back(e->getDest()->getId());
+            csr.weights.push_back(e->getWeight());
+        }
+        csr.offsets.push_back(csr.targets.size());
+    }
+    csr.targets.shrink_to_fit();
+    csr.weights.shrink_to_fit();
+    frozen = true;
+    candidates = CandidateLists();
+    updateGeoDistances();
+    updateDistanceMatrix();
+}
+
+/**
+ * @brief Adds all edges from a compressed-sparse-row copy and adopts it as the frozen view.
+ *
+ * Used to restore a saved graph: the arrays are copied as they are instead of being rebuilt by freeze(),
+ * and the adjacency lists are created in CSR order, so the graph is the same as the one that was saved.
+ * The vertices must already exist (with ids 0 .. V-1) and have no edges.
+ *
+ * @param offsets V + 1 offsets into targets and weights.
+ * @param targets The target id of every edge.
+ * @param weights The weight of every edge.
+ *
+ * @complexity Time Complexity: O(V + E), where V is the number of vertices and E is the number of edges in the graph.
+ */
+void Graph::loadCSR(const unsigned* offsets, const int* targets, const double* weights) {
+    size_t n = vertexSet.size();
+    unsigned edges = offsets[n];
+    csr.offsets.assign(offsets, offsets + n + 1);
+    csr.targets.assign(targets, targets + edges);
+    csr.weights.assign(weights, weights + edges);
+
+    std::vector<unsigned> arriving(n, 0);
+    for (unsigned e = 0; e < edges; e++) {
+        arriving[targets[e]]++;
+    }
+    for (size_t v = 0; v < n; v++) {
+        vertexSet[v]->adj.reserve(offsets[v + 1] - offsets[v]);
+        vertexSet[v]->incoming.reserve(arriving[v]);
+    }
+    for (size_t v = 0; v < n; v++) {
+        for (unsigned e = offsets[v]; e < offsets[v + 1]; e++) {
+            vertexSet[v]->addEdge(vertexSet[targets[e]], weights[e]);
+        }
+    }
+    frozen = true;
+    candidates = CandidateLists();
+    updateGeoDistances();
+    updateDistanceMatrix();
+}
+
+/**
+ * @brief Builds the dense weight matrix for dense graphs (at least half of all possible edges) and drops it otherwise.
+ *
+ * @complexity Time Complexity: O(V^2 + E) for dense graphs, O(1) otherwise.
+ */
+void Graph::updateDistanceMatrix() {
+    double possible = (double) vertexSet.size() * (vertexSet.size() - 1);
+    if (vertexSet.size() > 1 && 2.0 * csr.targets.size() >= possible) {
+        buildDistanceMatrix(false);
+    }
+    else {
+        distMatrix.reset();
+    }
+}
 
+/**
+ * @brief Precomputes the coordinates of every vertex for haversine distances (see GeoDistances).
+ *
+ * @complexity Time Complexity: O(V)
+ */
+void Graph::updateGeoDistances() {
+    geo.reset(vertexSet.size());
+    for (auto v : vertexSet) {
+        if (v->hasCoord()) geo.set(v->getId(), v->getLat(), v->getLong());
+    }
+}
 
+/**
+ * @brief Gets the haversine distances between the vertices, as of the last call to freeze().
+ *
+ * @return The distances; vertices without coordinates are at infinite distance.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+const GeoDistances& Graph::getGeoDistances() const {
+    return geo;
+}
+
+/**
+ * @brief Checks if the compressed-sparse-row view is up to date with the graph.
+ *
+ * @return True if freeze() was called after the last change to the graph, false otherwise.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+bool Graph::isFrozen() const {
+    return frozen;
+}
+
+/**
+ * @brief Gets the compressed-sparse-row view built by the last call to freeze().
+ *
+ * @return The compressed-sparse-row view of the graph.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+const CSRGraph& Graph::getCSR() const {
+    return csr;
+}
+
+/**
+ * @brief Gets the weight of the edge between two vertices.
+ *
+ * @param source The id of the source vertex.
+ * @param dest The id of the destination vertex.
+ *
+ * @return The weight of the first edge from source to dest, or infinity if no such edge exists.
+ *
+ * @complexity Time Complexity: O(E), where E is the number of edges leaving the source vertex.
+ */
+double CSRGraph::getEdgeWeight(int source, int dest) const {
+    for (unsigned e = offsets[source]; e < offsets[source + 1]; e++) {
+        if (targets[e] == dest) {
+            return weights[e];
+        }
+    }
+    return std::numeric_limits<double>::infinity();
+}
+
+/**
+ * @brief Fills the dense weight matrix from the compressed-sparse-row view.
+ *
+ * Missing edges are stored as infinity, exactly as CSRGraph::getEdgeWeight reports them, so algorithms
+ * never use an edge that is not in the graph; as there, a vertex is at infinity from itself unless it has
+ * a self-loop. Tours that must cross a missing edge are priced by Data::calculateTourCost.
+ * freeze() calls this automatically for dense graphs; after that getEdgeWeight(int, int) is O(1).
+ *
+ * @param triangular True to store only the upper triangle; only valid for symmetric graphs.
+ *
+ * @complexity Time Complexity: O(V^2 + E), where V is the number of vertices and E is the number of edges in the graph.
+ */
+void Graph::buildDistanceMatrix(bool triangular) {
+    int n = vertexSet.size();
+    auto matrix = std::make_shared<DistanceMatrix>(n, triangular, std::numeric_limits<double>::infinity());
+    // Walk the edges backwards so that, as in CSRGraph::getEdgeWeight, the first parallel edge wins.
+    for (int v = n - 1; v >= 0; v--) {
+        for (unsigned e = csr.edgesEnd(v); e-- > csr.edgesBegin(v); ) {
+            matrix->set(v, csr.getTarget(e), csr.getWeight(e));
+        }
+    }
+    distMatrix = std::move(matrix);
+}
+
+/**
+ * @brief Replaces the dense weight matrix, e.g. by shortest-path distances (see MetricClosure).
+ *
+ * getEdgeWeight(int, int) then answers from the given matrix; the next freeze() rebuilds or drops it.
+ * The matrix is shared, not copied, so it must not change while the graph uses it.
+ *
+ * @param matrix A V x V matrix indexed by vertex id.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+void Graph::setDistanceMatrix(std::shared_ptr<const DistanceMatrix> matrix) {
+    distMatrix = std::move(matrix);
+}
+
+/**
+ * @brief Checks if the dense weight matrix is available.
+ *
+ * @return True if getEdgeWeight(int, int) is served by the dense matrix, false otherwise.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+bool Graph::hasDistanceMatrix() const {
+    return distMatrix != nullptr;
+}
+
+/**
+ * @brief Gets the dense weight matrix.
+ *
+ * @return The dense weight matrix, empty if the graph is sparse.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+const DistanceMatrix& Graph::getDistanceMatrix() const {
+    static const DistanceMatrix none;
+    return distMatrix ? *distMatrix : none;
+}
+
+/**
+ * @brief Precomputes the candidate neighbour lists of every vertex (see CandidateLists).
+ *
+ * Only edges of the frozen view are considered; quadrant neighbours are only added between vertices
+ * that both have coordinates. The lists stay valid until the next freeze().
+ *
+ * @param k The number of cheapest neighbours kept per vertex.
+ * @param quadrants True to also keep the cheapest neighbours in each quadrant.
+ *
+ * @complexity Time Complexity: O(V + E log D), where D is the maximum degree.
+ */
+void Graph::buildCandidates(int k, bool quadrants) {
+    auto start = std::chrono::steady_clock::now();
+    const int n = vertexSet.size();
+    const int perQuadrant = (k + 3) / 4;
+    candidates = CandidateLists();
+    candidates.k = k;
+    candidates.quadrants = quadrants;
+    candidates.offsets.assign(1, 0);
+    candidates.offsets.reserve(n + 1);
+
+    std::vector<unsigned> order;
+    std::vector<int> seenBy(n, -1);
+    for (int v = 0; v < n; v++) {
+        order.clear();
+        // As in CSRGraph::getEdgeWeight, only the first of several parallel edges counts.
+        for (unsigned e = csr.edgesBegin(v); e < csr.edgesEnd(v); e++) {
+            int u = csr.getTarget(e);
+            if (u == v || seenBy[u] == v) continue;
+            seenBy[u] = v;
+            order.push_back(e);
+        }
+        std::sort(order.begin(), order.end(), [this](unsigned a, unsigned b) {
+            return csr.getWeight(a) < csr.getWeight(b) || (csr.getWeight(a) == csr.getWeight(b) && a < b);
+        });
+
+        Vertex* from = vertexSet[v];
+        int cheapest = 0;
+        int inQuadrant[4] = {0, 0, 0, 0};
+        for (unsigned e : order) {
+            int u = csr.getTarget(e);
+            bool keep = cheapest < k;
+            if (keep) {
+                cheapest++;
+            }
+            Vertex* to = vertexSet[u];
+            if (quadrants && from->hasCoord() && to->hasCoord()) {
+                int q = (to->getLong() >= from->getLong()) + 2 * (to->getLat() >= from->getLat());
+                if (inQuadrant[q] < perQuadrant) {
+                    inQuadrant[q]++;
+                    keep = true;
+                }
+            }
+            if (keep) {
+                candidates.targets.push_back(u);
+                candidates.weights.push_back(csr.getWeight(e));
+            }
+        }
+        candidates.offsets.push_back(candidates.targets.size());
+        candidates.maxLength = std::max(candidates.maxLength, candidates.offsets[v + 1] - candidates.offsets[v]);
+    }
+    candidates.targets.shrink_to_fit();
+    candidates.weights.shrink_to_fit();
+    candidates.buildTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * @brief Checks if candidate lists were built for the current frozen view.
+ *
+ * @return True if buildCandidates was called after the last freeze() and the graph did not change since, false otherwise.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+bool Graph::hasCandidates() const {
+    return frozen && !candidates.empty();
+}
+
+/**
+ * @brief Gets the candidate lists built by the last call to buildCandidates.
+ *
+ * @return The candidate lists, empty if there are none.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+const CandidateLists& Graph::getCandidates() const {
+    return candidates;
+}
@@ -0,0 +1,251 @@
+#include "../headerFiles/KdTree.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief Constructs the tree over the vertices of a graph that have coordinates.
+ *
+ * @complexity Time Complexity: O(V log V)
+ */
+KdTree::KdTree(const Graph& graph) {
+    build(graph);
+}
+
+/**
+ * @brief Rebuilds the tree over the vertices of a graph that have coordinates; none is visited.
+ *
+ * @param graph The graph.
+ *
+ * @complexity Time Complexity: O(V log V)
+ */
+void KdTree::build(const Graph& graph) {
+    points.clear();
+    slot.assign(graph.getNumVertex(), -1);
+    for (auto v : graph.getVertexSet()) {
+        if (!v->hasCoord()) continue;
+        double lat = v->getLat() * M_PI / 180.0;
+        double lon = v->getLong() * M_PI / 180.0;
+        points.push_back({{cos(lat) * cos(lon), cos(lat) * sin(lon), sin(lat)}, v->getId()});
+    }
+    axis.assign(points.size(), 0);
+    alive.assign(points.size(), 0);
+    excluded.assign(points.size(), false);
+    buildRange(0, points.size());
+    for (int i = 0; i < size(); i++) {
+        slot[points[i].id] = i;
+    }
+}
+
+/**
+ * @brief Splits the range [lo, hi) at its median along the axis of largest spread, recursively.
+ *
+ * @complexity Time Complexity: O(N log N), where N = hi - lo.
+ */
+void KdTree::buildRange(int lo, int hi) {
+    if (lo >= hi) {
+        return;
+    }
+    double low[3] = {2, 2, 2}, high[3] = {-2, -2, -2};
+    for (int i = lo; i < hi; i++) {
+        for (int a = 0; a < 3; a++) {
+            low[a] = std::min(low[a], points[i].c[a]);
+            high[a] = std::max(high[a], points[i].c[a]);
+        }
+    }
+    int a = 0;
+    for (int b = 1; b < 3; b++) {
+        if (high[b] - low[b] > high[a] - low[a]) a = b;
+    }
+    int mid = (lo + hi) / 2;
+    std::nth_element(points.begin() + lo, points.begin() + mid, points.begin() + hi,
+                     [a](const Point& p, const Point& q) { return p.c[a] < q.c[a]; });
+    axis[mid] = a;
+    alive[mid] = hi - lo;
+    buildRange(lo, mid);
+    buildRange(mid + 1, hi);
+}
+
+/**
+ * @brief Gets the squared straight-line distance between two points on the unit sphere.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+double KdTree::chordSquared(const Point& a, const Point& b) {
+    double dx = a.c[0] - b.c[0], dy = a.c[1] - b.c[1], dz = a.c[2] - b.c[2];
+    return dx * dx + dy * dy + dz * dz;
+}
+
+/**
+ * @brief Gets the great-circle distance between two vertices of the tree.
+ *
+ * @return The distance in metres.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+double KdTree::distance(int u, int v) const {
+    double chord = std::sqrt(chordSquared(points[slot[u]], points[slot[v]]));
+    return 2 * GeoDistances::EARTH_RADIUS * std::asin(std::min(1.0, chord / 2));
+}
+
+/**
+ * @brief Keeps the k closest points of [lo, hi) to q, other than q itself, in the max-heap best.
+ *
+ * @complexity Time Complexity: O(k log N) on typical inputs.
+ */
+void KdTree::searchNearest(int lo, int hi, const Point& q, int k, std::vector<std::pair<double, int>>& best) const {
+    if (lo >= hi) {
+        return;
+    }
+    int mid = (lo + hi) / 2;
+    if (alive[mid] == 0) {
+        return;
+    }
+    const Point& p = points[mid];
+    if (!excluded[mid] && p.id != q.id) {
+        double d = chordSquared(p, q);
+        if ((int) best.size() < k) {
+            best.emplace_back(d, p.id);
+            std::push_heap(best.begin(), best.end());
+        }
+        else if (d < best.front().first) {
+            std::pop_heap(best.begin(), best.end());
+            best.back() = {d, p.id};
+            std::push_heap(best.begin(), best.end());
+        }
+    }
+    double diff = q.c[axis[mid]] - p.c[axis[mid]];
+    if (diff < 0) {
+        searchNearest(lo, mid, q, k, best);
+        if ((int) best.size() < k || diff * diff < best.front().first) searchNearest(mid + 1, hi, q, k, best);
+    }
+    else {
+        searchNearest(mid + 1, hi, q, k, best);
+        if ((int) best.size() < k || diff * diff < best.front().first) searchNearest(lo, mid, q, k, best);
+    }
+}
+
+/**
+ * @brief Collects the points of [lo, hi) within squared chord limit of q, other than q itself.
+ *
+ * @complexity Time Complexity: O(log N + R) on typical inputs, where R is the number of points found.
+ */
+void KdTree::searchRadius(int lo, int hi, const Point& q, double limit, std::vector<std::pair<double, int>>& found) const {
+    if (lo >= hi) {
+        return;
+    }
+    int mid = (lo + hi) / 2;
+    if (alive[mid] == 0) {
+        return;
+    }
+    const Point& p = points[mid];
+    if (!excluded[mid] && p.id != q.id) {
+        double d = chordSquared(p, q);
+        if (d <= limit) found.emplace_back(d, p.id);
+    }
+    double diff = q.c[axis[mid]] - p.c[axis[mid]];
+    if (diff < 0 || diff * diff <= limit) searchRadius(lo, mid, q, limit, found);
+    if (diff >= 0 || diff * diff <= limit) searchRadius(mid + 1, hi, q, limit, found);
+}
+
+/**
+ * @brief Finds the closest vertex to v that is not visited.
+ *
+ * @param v A vertex of the tree (visited or not).
+ * @return The id of the closest other vertex, or -1 if there is none.
+ *
+ * @complexity Time Complexity: O(log N) on typical inputs.
+ */
+int KdTree::nearest(int v) const {
+    std::vector<int> found = kNearest(v, 1);
+    return found.empty() ? -1 : found.front();
+}
+
+/**
+ * @brief Finds the k closest vertices to v that are not visited.
+ *
+ * @param v A vertex of the tree (visited or not).
+ * @param k The number of vertices wanted.
+ * @return The ids of up to k other vertices, closest first.
+ *
+ * @complexity Time Complexity: O(k log N) on typical inputs.
+ */
+std::vector<int> KdTree::kNearest(int v, int k) const {
+    std::vector<std::pair<double, int>> best;
+    if (!contains(v) || k <= 0) {
+        return {};
+    }
+    best.reserve(k);
+    searchNearest(0, size(), points[slot[v]], k, best);
+    std::sort_heap(best.begin(), best.end());
+    std::vector<int> result;
+    for (const auto& entry : best) {
+        result.push_back(entry.second);
+    }
+    return result;
+}
+
+/**
+ * @brief Finds the vertices that are not visited within a great-circle distance of v.
+ *
+ * @param v A vertex of the tree (visited or not).
+ * @param metres The distance.
+ * @return The ids of the other vertices in range, closest first.
+ *
+ * @complexity Time Complexity: O(log N + R log R) on typical inputs, where R is the number of vertices found.
+ */
+std::vector<int> KdTree::radius(int v, double metres) const {
+    std::vector<std::pair<double, int>> found;
+    if (!contains(v) || metres < 0) {
+        return {};
+    }
+    double chord = 2 * std::sin(std::min(metres / GeoDistances::EARTH_RADIUS, M_PI) / 2);
+    searchRadius(0, size(), points[slot[v]], chord * chord, found);
+    std::sort(found.begin(), found.end());
+    std::vector<int> result;
+    for (const auto& entry : found) {
+        result.push_back(entry.second);
+    }
+    return result;
+}
+
+/**
+ * @brief Excludes a vertex from the results of all further queries.
+ *
+ * @param v A vertex of the tree.
+ *
+ * @complexity Time Complexity: O(log N)
+ */
+void KdTree::markVisited(int v) {
+    int s = slot[v];
+    if (excluded[s]) {
+        return;
+    }
+    excluded[s] = true;
+    int lo = 0, hi = size();
+    while (true) {
+        int mid = (lo + hi) / 2;
+        alive[mid]--;
+        if (s == mid) break;
+        if (s < mid) hi = mid;
+        else lo = mid + 1;
+    }
+}
+
+/**
+ * @brief Includes every vertex in the queries again.
+ *
+ * @complexity Time Complexity: O(N)
+ */
+void KdTree::resetVisited() {
+    std::fill(excluded.begin(), excluded.end(), false);
+    std::vector<std::pair<int, int>> ranges = {{0, size()}};
+    while (!ranges.empty()) {
+        auto [lo, hi] = ranges.back();
+        ranges.pop_back();
+        if (lo >= hi) continue;
+        int mid = (lo + hi) / 2;
+        alive[mid] = hi - lo;
+        ranges.push_back({lo, mid});
+        ranges.push_back({mid + 1, hi});
+    }
+}
@@ -0,0 +1,302 @@
+#include "../headerFiles/LinKernighan.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+/**
+ * Maximum number of 2-opt moves in one Lin-Kernighan chain.
+ */
+static const size_t LK_MAX_DEPTH = 50;
+
+/**
+ * Number of alternatives tried for the first step of a chain.
+ */
+static const int LK_BREADTH = 3;
+
+/**
+ * Maximum length of each of the two segments swapped by a double-bridge kick.
+ */
+static const int LK_KICK_SEGMENT = 30;
+
+/**
+ * @brief Constructs the solver and precomputes the neighbour lists.
+ *
+ * @param graph The (frozen) graph the tours belong to.
+ * @param neighbours How many of the cheapest neighbours of each vertex are tried as new endpoints.
+ *
+ * @complexity Time Complexity: O(V * D log D), where D is the maximum degree.
+ */
+LinKernighan::LinKernighan(const Graph& graph, int neighbours) : LocalSearch(graph, neighbours), random(2024) {}
+
+/**
+ * @brief Improves a closed tour with chained Lin-Kernighan until the time budget runs out.
+ *
+ * @param tour Vertex ids, first == last. Replaced by the best tour found, still starting at the same vertex.
+ * @param timeLimit The time budget, in seconds.
+ *
+ * @return The cost of the best tour found.
+ *
+ * @complexity Time Complexity: bounded by timeLimit, plus the first descent to a local optimum.
+ */
+double LinKernighan::solve(std::vector<int>& tour, double timeLimit) {
+    progress.clear();
+    if (tour.size() < 2) {
+        return 0;
+    }
+    auto start = std::chrono::steady_clock::now();
+    auto elapsed = [&]() {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    int first = tour.front();
+    loadTour(tour);
+    if (n < 5) {
+        return storeTour(first, tour);
+    }
+    active.assign(graph.getNumVertex(), false);
+    queue.clear();
+    for (int i = n - 1; i >= 0; i--) {
+        activate(order[i]);
+    }
+    logReversals = true;
+    reversals.clear();
+    runQueue();
+
+    double bestCost = tourCost();
+    progress.emplace_back(elapsed(), bestCost);
+
+    // The cost after a kick is the kick's delta minus the gains of the moves that follow it; a rejected
+    // kick is undone by replaying those moves' reversals backwards and then swapping the segments back.
+    while (n >= 8 && elapsed() < timeLimit) {
+        reversals.clear();
+        double kick = doubleBridge();
+        double cost = bestCost + kick - runQueue();
+        if (!std::isfinite(cost)) {
+            cost = tourCost();
+        }
+        if (cost < bestCost - IMPROVEMENT_EPS) {
+            bestCost = cost;
+            progress.emplace_back(elapsed(), bestCost);
+        }
+        else {
+            for (auto it = reversals.rbegin(); it != reversals.rend(); ++it) {
+                reverseSpan(it->first, it->second);
+            }
+            swapSegments(kickPosition, kickLengths.second, kickLengths.first);
+        }
+    }
+    logReversals = false;
+    return storeTour(first, tour);
+}
+
+/**
+ * @brief Gets the cost of the best tour over time, for the last call to solve.
+ *
+ * @return Pairs of (seconds since the start, best cost so far), one for every improvement.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+const std::vector<std::pair<double, double>>& LinKernighan::getProgress() const {
+    return progress;
+}
+
+/**
+ * @brief Tries a Lin-Kernighan chain and then Or-opt moves around a vertex.
+ *
+ * @param a The vertex.
+ *
+ * @return True if a move was applied, false otherwise.
+ *
+ * @complexity Time Complexity: O(LK_BREADTH * LK_MAX_DEPTH * (k + N)), or O(LK_BREADTH * LK_MAX_DEPTH * (k D + N)) without a dense weight matrix.
+ */
+bool LinKernighan::improve(int a) {
+    return improveLK(a) || (useOrOpt && improveOrOpt(a));
+}
+
+/**
+ * @brief Tries Lin-Kernighan chains that start by breaking one of the two tour edges of t1.
+ *
+ * The LK_BREADTH most promising first steps are tried in turn; the deeper steps are chosen greedily.
+ *
+ * @param t1 The vertex.
+ *
+ * @return True if an improving chain was applied, false otherwise.
+ *
+ * @complexity Time Complexity: O(LK_BREADTH * LK_MAX_DEPTH * (k + N)), or O(LK_BREADTH * LK_MAX_DEPTH * (k D + N)) without a dense weight matrix.
+ */
+bool LinKernighan::improveLK(int t1) {
+    for (int side = 0; side < 2; side++) {
+        int t2 = side == 0 ? next(t1) : prev(t1);
+        double g0 = dist(t1, t2);
+
+        std::vector<std::pair<double, int>> firstSteps;
+        for (int i = 0; i < k; i++) {
+            int t3 = neighbours[(size_t) t2 * k + i];
+            if (t3 < 0) break;
+            double g1 = g0 - neighbourWeights[(size_t) t2 * k + i];
+            if (g1 <= IMPROVEMENT_EPS) break;
+            if (pos[t3] < 0 || t3 == t1) continue;
+            int t4 = side == 0 ? prev(t3) : next(t3);
+            if (t4 == t2) continue;
+            firstSteps.emplace_back(g1 + dist(t3, t4), t3);
+        }
+        std::sort(firstSteps.rbegin(), firstSteps.rend());
+        if (firstSteps.size() > (size_t) LK_BREADTH) {
+            firstSteps.resize(LK_BREADTH);
+        }
+
+        for (const auto& step : firstSteps) {
+            int t3 = step.second;
+            int t4 = next(t1) == t2 ? prev(t3) : next(t3);
+            moves.clear();
+            moves.push_back({t1, t2, t3, t4, reversals.size()});
+            move2opt(t1, t2, t4);
+            if (extendChain(t1, t4, step.first)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Extends the chain in moves greedily and keeps its most profitable prefix.
+ *
+ * @param t1 The fixed end of the chain.
+ * @param t2 The loose end; (t1, t2) is the closing edge of the current tour.
+ * @param gain Removed minus added weight of the chain so far, not counting the closing edge.
+ *
+ * @return True if a prefix of the chain improves the tour (it is left applied), false if the whole chain was undone.
+ *
+ * @complexity Time Complexity: O(LK_MAX_DEPTH * (k + N)), or O(LK_MAX_DEPTH * (k D + N)) without a dense weight matrix.
+ */
+bool LinKernighan::extendChain(int t1, int t2, double gain) {
+    double bestGain = IMPROVEMENT_EPS;
+    size_t best = 0;
+    if (gain - dist(t2, t1) > bestGain) {
+        bestGain = gain - dist(t2, t1);
+        best = 1;
+    }
+    auto added = [&](int u, int v) {
+        for (const auto& m : moves) {
+            if ((m.t2 == u && m.t3 == v) || (m.t2 == v && m.t3 == u)) return true;
+        }
+        return false;
+    };
+
+    while (moves.size() < LK_MAX_DEPTH) {
+        bool forward = next(t1) == t2;
+        int bestT3 = -1, bestT4 = -1;
+        double bestScore = 0;
+        for (int i = 0; i < k; i++) {
+            int t3 = neighbours[(size_t) t2 * k + i];
+            if (t3 < 0) break;
+            double g1 = gain - neighbourWeights[(size_t) t2 * k + i];
+            if (g1 <= IMPROVEMENT_EPS) break;
+            if (pos[t3] < 0 || t3 == t1) continue;
+            int t4 = forward ? prev(t3) : next(t3);
+            if (t4 == t2 || added(t3, t4)) continue;
+            double score = g1 + dist(t3, t4);
+            if (bestT3 < 0 || score > bestScore) {
+                bestT3 = t3;
+                bestT4 = t4;
+                bestScore = score;
+            }
+        }
+        if (bestT3 < 0) break;
+
+        moves.push_back({t1, t2, bestT3, bestT4, reversals.size()});
+        move2opt(t1, t2, bestT4);
+        gain = bestScore;
+        t2 = bestT4;
+        if (gain - dist(t2, t1) > bestGain) {
+            bestGain = gain - dist(t2, t1);
+            best = moves.size();
+        }
+    }
+
+    undoMoves(best);
+    if (best > 0) {
+        gained += bestGain;
+    }
+    for (const auto& m : moves) {
+        activate(m.t1);
+        activate(m.t2);
+        activate(m.t3);
+        activate(m.t4);
+    }
+    return best > 0;
+}
+
+/**
+ * @brief Undoes the last moves of the chain until only the first keep are applied.
+ *
+ * Each move is undone by replaying its logged reversal, which also takes it out of the log.
+ *
+ * @param keep How many moves stay applied.
+ *
+ * @complexity Time Complexity: O(N) per undone move.
+ */
+void LinKernighan::undoMoves(size_t keep) {
+    if (moves.size() <= keep) {
+        return;
+    }
+    size_t logged = moves[keep].logged;
+    while (reversals.size() > logged) {
+        reverseSpan(reversals.back().first, reversals.back().second);
+        reversals.pop_back();
+    }
+    moves.resize(keep);
+}
+
+/**
+ * @brief Applies a random double-bridge kick: two short consecutive segments swap places.
+ *
+ * Only the two segments are rewritten, so a kick costs O(LK_KICK_SEGMENT) instead of O(N). The position
+ * and lengths are kept in kickPosition and kickLengths so that the kick can be undone.
+ *
+ * @return How much more expensive the tour got.
+ *
+ * @complexity Time Complexity: O(LK_KICK_SEGMENT)
+ */
+double LinKernighan::doubleBridge() {
+    int maxLength = std::max(1, std::min(LK_KICK_SEGMENT, (n - 2) / 2));
+    std::uniform_int_distribution<int> anyPosition(0, n - 1);
+    std::uniform_int_distribution<int> anyLength(1, maxLength);
+    int p = anyPosition(random);
+    int l1 = anyLength(random);
+    int l2 = anyLength(random);
+    auto at = [&](int i) { return order[(p + i) % n]; };
+
+    double removed = dist(at(0), at(1)) + dist(at(l1), at(l1 + 1)) + dist(at(l1 + l2), at(l1 + l2 + 1));
+    swapSegments(p, l1, l2);
+    double added = dist(at(0), at(1)) + dist(at(l2), at(l2 + 1)) + dist(at(l1 + l2), at(l1 + l2 + 1));
+    kickPosition = p;
+    kickLengths = {l1, l2};
+
+    activate(at(0));
+    activate(at(1));
+    activate(at(l2));
+    activate(at(l2 + 1));
+    activate(at(l1 + l2));
+    activate(at(l1 + l2 + 1));
+    return added - removed;
+}
+
+/**
+ * @brief Swaps the segment of l1 vertices after position p with the l2 vertices that follow it.
+ *
+ * @complexity Time Complexity: O(l1 + l2)
+ */
+void LinKernighan::swapSegments(int p, int l1, int l2) {
+    std::vector<int> segments;
+    for (int i = 1; i <= l1 + l2; i++) {
+        segments.push_back(order[(p + i) % n]);
+    }
+    std::rotate(segments.begin(), segments.begin() + l1, segments.end());
+    for (int i = 0; i < l1 + l2; i++) {
+        int at = (p + 1 + i) % n;
+        order[at] = segments[i];
+        pos[segments[i]] = at;
+    }
+}
@@ -0,0 +1,377 @@
+#include "../headerFiles/LocalSearch.h"
+#include <algorithm>
+
+/**
+ * @brief Constructs the local search engine and precomputes the neighbour lists.
+ *
+ * @param graph The (frozen) graph the tours belong to.
+ * @param neighbours How many of the cheapest neighbours of each vertex are tried as new endpoints.
+ *
+ * @complexity Time Complexity: O(V * D log k), where D is the maximum degree and k the number of neighbours.
+ */
+LocalSearch::LocalSearch(const Graph& graph, int neighbours) : graph(graph), n(0), k(neighbours),
+        useTwoOpt(true), useOrOpt(true) {
+    buildNeighbours();
+}
+
+/**
+ * @brief Chooses which moves are applied.
+ *
+ * @param twoOpt True to apply 2-opt moves.
+ * @param orOpt True to apply Or-opt moves (segments of up to 3 vertices, in either orientation).
+ *
+ * @complexity Time Complexity: O(1)
+ */
+void LocalSearch::setMoves(bool twoOpt, bool orOpt) {
+    useTwoOpt = twoOpt;
+    useOrOpt = orOpt;
+}
+
+/**
+ * @brief Stores, for every vertex, its k cheapest neighbours in increasing order of weight, with the weights.
+ *
+ * When the graph has candidate lists (Graph::buildCandidates) they are copied instead, quadrant
+ * neighbours included, and k becomes the length of the longest list. As in Graph::getEdgeWeight, the
+ * first of several parallel edges is the one that counts.
+ *
+ * @complexity Time Complexity: O(V * D log k), where D is the maximum degree, or O(V * k) from candidate lists.
+ */
+void LocalSearch::buildNeighbours() {
+    const CSRGraph& csr = graph.getCSR();
+    int vertices = csr.getNumVertex();
+    if (graph.hasCandidates()) {
+        const CandidateLists& lists = graph.getCandidates();
+        k = lists.getMaxLength();
+        neighbours.assign((size_t) vertices * k, -1);
+        neighbourWeights.assign((size_t) vertices * k, 0);
+        for (int v = 0; v < vertices; v++) {
+            for (unsigned c = lists.begin(v); c < lists.end(v); c++) {
+                neighbours[(size_t) v * k + (c - lists.begin(v))] = lists.getTarget(c);
+                neighbourWeights[(size_t) v * k + (c - lists.begin(v))] = lists.getWeight(c);
+            }
+        }
+        return;
+    }
+    neighbours.assign((size_t) vertices * k, -1);
+    neighbourWeights.assign((size_t) vertices * k, 0);
+    std::vector<std::pair<double, int>> candidates;
+    std::vector<int> seenBy(vertices, -1);
+    for (int v = 0; v < vertices; v++) {
+        candidates.clear();
+        for (unsigned e = csr.edgesBegin(v); e < csr.edgesEnd(v); e++) {
+            int u = csr.getTarget(e);
+            if (u == v || seenBy[u] == v) continue;
+            seenBy[u] = v;
+            candidates.emplace_back(csr.getWeight(e), u);
+        }
+        std::sort(candidates.begin(), candidates.end());
+        for (size_t i = 0; i < candidates.size() && (int) i < k; i++) {
+            neighbours[(size_t) v * k + i] = candidates[i].second;
+            neighbourWeights[(size_t) v * k + i] = candidates[i].first;
+        }
+    }
+}
+
+/**
+ * @brief Improves a closed tour until no 2-opt or Or-opt move among the neighbour lists helps.
+ *
+ * @param tour Vertex ids, first == last. Replaced by the improved tour, still starting at the same vertex.
+ *
+ * @return The cost of the improved tour (infinity if it still uses a missing edge).
+ *
+ * @complexity Time Complexity: O(k) per evaluated vertex (O(k D) without a dense weight matrix) and O(N) per applied move.
+ */
+double LocalSearch::optimize(std::vector<int>& tour) {
+    if (tour.size() < 2) {
+        return 0;
+    }
+    int start = tour.front();
+    loadTour(tour);
+    if (n >= 5) {
+        active.assign(graph.getNumVertex(), false);
+        queue.clear();
+        for (int i = n - 1; i >= 0; i--) {
+            activate(order[i]);
+        }
+        runQueue();
+    }
+    return storeTour(start, tour);
+}
+
+/**
+ * @brief Makes a closed tour the current tour.
+ *
+ * @param tour Vertex ids, first == last.
+ *
+ * @complexity Time Complexity: O(V)
+ */
+void LocalSearch::loadTour(const std::vector<int>& tour) {
+    order.assign(tour.begin(), tour.end() - 1);
+    n = order.size();
+    pos.assign(graph.getNumVertex(), -1);
+    for (int i = 0; i < n; i++) {
+        pos[order[i]] = i;
+    }
+}
+
+/**
+ * @brief Writes the current tour as a closed tour that starts at the given vertex.
+ *
+ * @param start The first (and last) vertex of the tour.
+ * @param tour Replaced by the current tour.
+ *
+ * @return The cost of the tour.
+ *
+ * @complexity Time Complexity: O(N), or O(N D) without a dense weight matrix.
+ */
+double LocalSearch::storeTour(int start, std::vector<int>& tour) const {
+    double cost = 0;
+    tour.clear();
+    for (int i = 0, v = start; i < n; i++, v = next(v)) {
+        tour.push_back(v);
+        // A single vertex closes its tour without using an edge.
+        if (n > 1) cost += dist(v, next(v));
+    }
+    tour.push_back(start);
+    return cost;
+}
+
+/**
+ * @brief Gets the cost of the current tour.
+ *
+ * @complexity Time Complexity: O(N), or O(N D) without a dense weight matrix.
+ */
+double LocalSearch::tourCost() const {
+    double cost = 0;
+    for (int i = 0; i < n; i++) {
+        cost += dist(order[i], order[i + 1 == n ? 0 : i + 1]);
+    }
+    return cost;
+}
+
+/**
+ * @brief Applies moves around the active vertices until none of them can be improved.
+ *
+ * @return How much cheaper the tour got.
+ *
+ * @complexity Time Complexity: O(k) per evaluated vertex (O(k D) without a dense weight matrix) and O(N) per applied move.
+ */
+double LocalSearch::runQueue() {
+    gained = 0;
+    while (!queue.empty()) {
+        int a = queue.back();
+        queue.pop_back();
+        active[a] = false;
+        if (improve(a)) {
+            activate(a);
+        }
+    }
+    return gained;
+}
+
+/**
+ * @brief Tries the enabled moves around a vertex.
+ *
+ * @param a The vertex.
+ *
+ * @return True if a move was applied, false otherwise.
+ *
+ * @complexity Time Complexity: O(k) to evaluate (O(k D) without a dense weight matrix), O(N) to apply.
+ */
+bool LocalSearch::improve(int a) {
+    return (useTwoOpt && improveTwoOpt(a)) || (useOrOpt && improveOrOpt(a));
+}
+
+/**
+ * @brief Marks a vertex as worth another look.
+ *
+ * @param v The vertex.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+void LocalSearch::activate(int v) {
+    if (!active[v]) {
+        active[v] = true;
+        queue.push_back(v);
+    }
+}
+
+/**
+ * @brief Tries 2-opt moves that connect a to one of its neighbours, on both sides of a.
+ *
+ * @param a The vertex.
+ *
+ * @return True if a move was applied, false otherwise.
+ *
+ * @complexity Time Complexity: O(k) to evaluate (O(k D) without a dense weight matrix), O(N) to apply.
+ */
+bool LocalSearch::improveTwoOpt(int a) {
+    for (int side = 0; side < 2; side++) {
+        int b = side == 0 ? next(a) : prev(a);
+        double dab = dist(a, b);
+        for (int i = 0; i < k; i++) {
+            int c = neighbours[(size_t) a * k + i];
+            if (c < 0) break;
+            double dac = neighbourWeights[(size_t) a * k + i];
+            if (dac >= dab) break;
+            if (pos[c] < 0) continue;
+            int d = side == 0 ? next(c) : prev(c);
+            if (c == b || d == a) continue;
+            double delta = dac + dist(b, d) - dab - dist(c, d);
+            if (delta < -IMPROVEMENT_EPS) {
+                gained -= delta;
+                if (side == 0) move2opt(a, b, c);
+                else move2opt(b, a, d);
+                activate(a);
+                activate(b);
+                activate(c);
+                activate(d);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Tries to move a segment of 1 to 3 vertices that starts or ends at a somewhere else in the tour.
+ *
+ * @param a The vertex.
+ *
+ * @return True if a move was applied, false otherwise.
+ *
+ * @complexity Time Complexity: O(k) to evaluate (O(k D) without a dense weight matrix), O(N) to apply.
+ */
+bool LocalSearch::improveOrOpt(int a) {
+    for (int length = 1; length <= 3 && length + 3 <= n; length++) {
+        for (int side = 0; side < (length == 1 ? 1 : 2); side++) {
+            int s1 = a, s2 = a;
+            for (int i = 1; i < length; i++) {
+                if (side == 0) s2 = next(s2);
+                else s1 = prev(s1);
+            }
+            int p = prev(s1), nx = next(s2);
+            double removeGain = dist(p, s1) + dist(s2, nx) - dist(p, nx);
+            if (!(removeGain > IMPROVEMENT_EPS)) continue;
+            if (tryInsert(s1, s2, removeGain)) return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Looks for a cheaper place for the segment s1..s2 next to a neighbour of s1 or s2, and moves it there.
+ *
+ * @param s1 First vertex of the segment.
+ * @param s2 Last vertex of the segment, at most two steps after s1.
+ * @param removeGain How much cheaper the tour gets by taking the segment out.
+ *
+ * @return True if the segment was moved, false otherwise.
+ *
+ * @complexity Time Complexity: O(k) to evaluate (O(k D) without a dense weight matrix), O(N) to apply (three path reversals, each of the shorter side).
+ */
+bool LocalSearch::tryInsert(int s1, int s2, double removeGain) {
+    int middle = s1 != s2 && next(s1) != s2 ? next(s1) : s1;
+    auto inSegment = [&](int v) { return v == s1 || v == s2 || v == middle; };
+    int p = prev(s1), nx = next(s2);
+
+    for (int end = 0; end < 2; end++) {
+        int attach = end == 0 ? s1 : s2;
+        int other = end == 0 ? s2 : s1;
+        for (int i = 0; i < k; i++) {
+            int c = neighbours[(size_t) attach * k + i];
+            if (c < 0) break;
+            double dca = neighbourWeights[(size_t) attach * k + i];
+            if (dca >= removeGain) break;
+            if (pos[c] < 0 || inSegment(c)) continue;
+
+            // Between c and next(c), with attach next to c.
+            int x = c, y = next(c);
+            bool ok = c != p;
+            double add = dca + dist(other, y) - dist(x, y);
+            bool firstNextToX = end == 0;
+            if (!ok || !(add - removeGain < -IMPROVEMENT_EPS)) {
+                // Between prev(c) and c, with attach next to c.
+                x = prev(c);
+                y = c;
+                ok = c != nx;
+                add = dist(x, other) + dca - dist(x, y);
+                firstNextToX = end == 1;
+                if (!ok || !(add - removeGain < -IMPROVEMENT_EPS)) continue;
+            }
+
+            // Three 2-opt moves: (p, s1), (x, y) -> (p, x), (s1, y) leaves p x .. nx s2 .. s1 y, then
+            // (p, x), (nx, s2) -> (p, nx), (x, s2) puts the segment between x and y, reversed; the last
+            // move turns it around when s1 goes next to x.
+            gained += removeGain - add;
+            move2opt(p, s1, x);
+            if (x != nx) move2opt(p, x, nx);
+            if (firstNextToX) move2opt(x, s2, s1);
+
+            activate(p);
+            activate(nx);
+            activate(s1);
+            activate(s2);
+            activate(x);
+            activate(y);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Replaces the tour edges (a, b) and (c, d) by (a, c) and (b, d), where d is the neighbour of c
+ * on the same side as b is of a.
+ *
+ * Either b follows a and d follows c, or b precedes a and d precedes c; the first case reverses b .. c and
+ * the second c .. b, so d never needs to be given.
+ *
+ * @complexity Time Complexity: O(N)
+ */
+void LocalSearch::move2opt(int a, int b, int c) {
+    if (next(a) == b) {
+        reversePath(b, c);
+    }
+    else {
+        reversePath(c, b);
+    }
+}
+
+/**
+ * @brief Reverses the part of the tour that goes from vertex from to vertex to.
+ *
+ * Reversing the rest of the tour instead gives the same cycle, so the shorter of the two is reversed.
+ *
+ * @complexity Time Complexity: O(N)
+ */
+void LocalSearch::reversePath(int from, int to) {
+    int i = pos[from];
+    int length = (pos[to] - i + n) % n + 1;
+    if (2 * length > n) {
+        i = pos[next(to)];
+        length = n - length;
+    }
+    if (logReversals) {
+        reversals.emplace_back(i, length);
+    }
+    reverseSpan(i, length);
+}
+
+/**
+ * @brief Reverses the length entries of order that start at position i, wrapping around.
+ *
+ * Applying it twice restores the tour, which is how logged reversals are undone.
+ *
+ * @complexity Time Complexity: O(length)
+ */
+void LocalSearch::reverseSpan(int i, int length) {
+    int j = (i + length - 1) % n;
+    for (int step = 0; step < length / 2; step++) {
+        std::swap(order[i], order[j]);
+        pos[order[i]] = i;
+        pos[order[j]] = j;
+        i = i + 1 == n ? 0 : i + 1;
+        j = j == 0 ? n - 1 : j - 1;
+    }
+}
@@ -0,0 +1,75 @@
+#include "../headerFiles/MappedFile.h"
+#include <fstream>
+#include <ios>
+#include <sstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define PROJ2DA_HAS_MMAP 1
+#endif
+
+/**
+ * @brief Maps a file into memory.
+ *
+ * @param path Path to the file.
+ * @throws std::ios_base::failure if the file cannot be opened or mapped.
+ *
+ * @complexity Time Complexity: O(1) when mapped (pages are loaded on first access), O(S) otherwise, where S is the file size.
+ */
+MappedFile::MappedFile(const std::string& path) : data(""), length(0), mapped(false) {
+    auto fail = [&path]() {
+        std::ostringstream error_message;
+        error_message << "Could not open file \"" << path << '"';
+        throw std::ios_base::failure(error_message.str());
+    };
+
+#ifdef PROJ2DA_HAS_MMAP
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        fail();
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        fail();
+    }
+    length = info.st_size;
+    if (length > 0) {
+        void* p = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            close(fd);
+            fail();
+        }
+        madvise(p, length, MADV_SEQUENTIAL);
+        data = static_cast<const char*>(p);
+        mapped = true;
+    }
+    close(fd);
+#else
+    std::ifstream file(path, std::ios::binary);
+    if (file.fail()) {
+        fail();
+    }
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    buffer = contents.str();
+    data = buffer.data();
+    length = buffer.size();
+#endif
+}
+
+/**
+ * @brief Unmaps the file.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+MappedFile::~MappedFile() {
+#ifdef PROJ2DA_HAS_MMAP
+    if (mapped) {
+        munmap(const_cast<char*>(data), length);
+    }
+#endif
+}
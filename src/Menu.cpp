@@ -1,4 +1,5 @@
 #include "Menu.h"
+#include "ThreadPool.h"
 #include <iomanip>
 #include <iostream>
 #include <chrono>
@@ -146,73 +147,58 @@ void Menu::drawBottom(){
 void Menu::drawMenu(int option) {
     data_ = Data();
     if(option ==1){
-        data_.parseTOY(false,"../dataset/Toy-Graphs/Toy-Graphs/shipping.csv");
+        data_.loadTOY(false, "../dataset/Toy-Graphs/Toy-Graphs/shipping.csv");
     }
     else if(option == 2){
-        data_.parseTOY(false,"../dataset/Toy-Graphs/Toy-Graphs/stadiums.csv");
+        data_.loadTOY(false, "../dataset/Toy-Graphs/Toy-Graphs/stadiums.csv");
     }
     else if(option == 3){
-        data_.parseTOY(true,"../dataset/Toy-Graphs/Toy-Graphs/tourism.csv");
+        data_.loadTOY(true, "../dataset/Toy-Graphs/Toy-Graphs/tourism.csv");
     }
     else if(option == 4){
-        data_.readNodes("../dataset/Real-world Graphs/Real-world Graphs/graph1/nodes.csv", -1);
-        data_.readEdges(true,"../dataset/Real-world Graphs/Real-world Graphs/graph1/edges.csv");
+        data_.loadGraph("../dataset/Real-world Graphs/Real-world Graphs/graph1/nodes.csv", -1, true, "../dataset/Real-world Graphs/Real-world Graphs/graph1/edges.csv");
     }
     else if(option == 5){
-        data_.readNodes("../dataset/Real-world Graphs/Real-world Graphs/graph2/nodes.csv", -1);
-        data_.readEdges(true,"../dataset/Real-world Graphs/Real-world Graphs/graph2/edges.csv");
+        data_.loadGraph("../dataset/Real-world Graphs/Real-world Graphs/graph2/nodes.csv", -1, true, "../dataset/Real-world Graphs/Real-world Graphs/graph2/edges.csv");
     }
     else if(option == 6){
-        data_.readNodes("../dataset/Real-world Graphs/Real-world Graphs/graph3/nodes.csv", -1);
-        data_.readEdges(true,"../dataset/Real-world Graphs/Real-world Graphs/graph3/edges.csv");
+        data_.loadGraph("../dataset/Real-world Graphs/Real-world Graphs/graph3/nodes.csv", -1, true, "../dataset/Real-world Graphs/Real-world Graphs/graph3/edges.csv");
     }
     else if(option == 7){
-        data_.readNodes("../dataset/Extra_Fully_Connected_Graphs/Extra_Fully_Connected_Graphs/nodes.csv", 25);
-        data_.readEdges(false,"../dataset/Extra_Fully_Connected_Graphs/Extra_Fully_Connected_Graphs/edges_25.csv");
+        data_.loadGraph("../dataset/Extra_Fully_Connected_Graphs/Extra_Fully_Connected_Graphs/nodes.csv", 25, false, "../dataset/Extra_Fully_Connected_Graphs/Extra_Fully_Connected_Graphs/edges_25.csv");
     }
     else if(option == 8){
-        data_.readNodes("../dataset/Extra_Fully_Connected_Graphs/Extra_Fully_Connected_Graphs/nodes.csv", 50);
-        data_.readEdges(false,"../dataset/Extra_Fully_Connected_Graphs/Extra_Fully_Connected_Graphs/edges_50.csv");
+        data_.loadGraph("../dataset/Extra_Fully_Connected_Graphs/Extra_Fully_Connected_Graphs/nodes.csv", 50, false, "../dataset/Extra_Fully_Connected_Graphs/Extra_Fully_Connected_Graphs/edges_50.csv");
     }
     else if(option == 9){
-        data_.readNodes("../dataset/Extra_Fully_Connected_Graphs/Extra_Fully_Connected_Graphs/nodes.csv", 75);
-        data_.readEdges(false,"../dataset/Extra_Fully_Connected_Graphs/Extra_Fully_Connected_Graphs/edges_75.csv");
+        data_.loadGraph("../dataset/Extra_Fully_Connected_Graphs/Extra_Fully_Connected_Graphs/nodes.csv", 75, false, "../dataset/Extra_Fully_Connected_Graphs/Extra_Fully_Connected_Graphs/edges_75.csv");
     }
     else if(option == 10){
-        data_.readNodes("../dataset/Extra_Fully_Connected_Graphs/Extra_Fully_Connected_Graphs/nodes.csv", 100);
-        data_.readEdges(false,"../dataset/Extra_Fully_Connected_Graphs/Extra_Fully_Connected_Graphs/edges_100.csv");
+        data_.loadGraph("../dataset/Extra_Fully_Connected_Graphs/Extra_Fully_Connected_Graphs/nodes.csv", 100, false, "../dataset/Extra_Fully_Connected_Graphs/Extra_Fully_Connected_Graphs/edges_100.csv");
     }
     else if(option == 11){
-        data_.readNodes("../dataset/Extra_Fully_Connected_Graphs/Extra_Fully_Connected_Graphs/nodes.csv", 200);
-        data_.readEdges(false,"../dataset/Extra_Fully_Connected_Graphs/Extra_Fully_Connected_Graphs/edges_200.csv");
+        data_.loadGraph("../dataset/Extra_Fully_Connected_Graphs/Extra_Fully_Connected_Graphs/nodes.csv", 200, false, "../dataset/Extra_Fully_Connected_Graphs/Extra_Fully_Connected_Graphs/edges_200.csv");
     }
     else if(option == 12){
-        data_.readNodes("../dataset/Extra_Fully_Connected_Graphs/Extra_Fully_Connected_Graphs/nodes.csv", 300);
-        data_.readEdges(false,"../dataset/Extra_Fully_Connected_Graphs/Extra_Fully_Connected_Graphs/edges_300.csv");
+        data_.loadGraph("../dataset/Extra_Fully_Connected_Graphs/Extra_Fully_Connected_Graphs/nodes.csv", 300, false, "../dataset/Extra_Fully_Connected_Graphs/Extra_Fully_Connected_Graphs/edges_300.csv");
     }
     else if(option == 13){
-        data_.readNodes("../dataset/Extra_Fully_Connected_Graphs/Extra_Fully_Connected_Graphs/nodes.csv", 400);
-        data_.readEdges(false,"../dataset/Extra_Fully_Connected_Graphs/Extra_Fully_Connected_Graphs/edges_400.csv");
+        data_.loadGraph("../dataset/Extra_Fully_Connected_Graphs/Extra_Fully_Connected_Graphs/nodes.csv", 400, false, "../dataset/Extra_Fully_Connected_Graphs/Extra_Fully_Connected_Graphs/edges_400.csv");
     }
     else if(option == 14){
-        data_.readNodes("../dataset/Extra_Fully_Connected_Graphs/Extra_Fully_Connected_Graphs/nodes.csv", 500);
-        data_.readEdges(false,"../dataset/Extra_Fully_Connected_Graphs/Extra_Fully_Connected_Graphs/edges_500.csv");
+        data_.loadGraph("../dataset/Extra_Fully_Connected_Graphs/Extra_Fully_Connected_Graphs/nodes.csv", 500, false, "../dataset/Extra_Fully_Connected_Graphs/Extra_Fully_Connected_Graphs/edges_500.csv");
     }
     else if(option == 15){
-        data_.readNodes("../dataset/Extra_Fully_Connected_Graphs/Extra_Fully_Connected_Graphs/nodes.csv", 600);
-        data_.readEdges(false,"../dataset/Extra_Fully_Connected_Graphs/Extra_Fully_Connected_Graphs/edges_600.csv");
+        data_.loadGraph("../dataset/Extra_Fully_Connected_Graphs/Extra_Fully_Connected_Graphs/nodes.csv", 600, false, "../dataset/Extra_Fully_Connected_Graphs/Extra_Fully_Connected_Graphs/edges_600.csv");
     }
     else if(option == 16){
-        data_.readNodes("../dataset/Extra_Fully_Connected_Graphs/Extra_Fully_Connected_Graphs/nodes.csv", 700);
-        data_.readEdges(false,"../dataset/Extra_Fully_Connected_Graphs/Extra_Fully_Connected_Graphs/edges_700.csv");
+        data_.loadGraph("../dataset/Extra_Fully_Connected_Graphs/Extra_Fully_Connected_Graphs/nodes.csv", 700, false, "../dataset/Extra_Fully_Connected_Graphs/Extra_Fully_Connected_Graphs/edges_700.csv");
     }
     else if(option == 17){
-        data_.readNodes("../dataset/Extra_Fully_Connected_Graphs/Extra_Fully_Connected_Graphs/nodes.csv", 800);
-        data_.readEdges(false,"../dataset/Extra_Fully_Connected_Graphs/Extra_Fully_Connected_Graphs/edges_800.csv");
+        data_.loadGraph("../dataset/Extra_Fully_Connected_Graphs/Extra_Fully_Connected_Graphs/nodes.csv", 800, false, "../dataset/Extra_Fully_Connected_Graphs/Extra_Fully_Connected_Graphs/edges_800.csv");
     }
     else if(option == 18){
-        data_.readNodes("../dataset/Extra_Fully_Connected_Graphs/Extra_Fully_Connected_Graphs/nodes.csv", 900);
-        data_.readEdges(false,"../dataset/Extra_Fully_Connected_Graphs/Extra_Fully_Connected_Graphs/edges_900.csv");
+        data_.loadGraph("../dataset/Extra_Fully_Connected_Graphs/Extra_Fully_Connected_Graphs/nodes.csv", 900, false, "../dataset/Extra_Fully_Connected_Graphs/Extra_Fully_Connected_Graphs/edges_900.csv");
     }
     char key;
     bool flag = true;
@@ -220,13 +206,15 @@ void Menu::drawMenu(int option) {
         drawTop();
         cout << "│" << setw(53) << "│" << endl;
         cout << "│    Options:                                      │" << endl;
-        cout << "│     [1] Backtracking Algorithm                   │" << endl;
+        cout << "│     [1] Exact Algorithms                         │" << endl;
         cout << "│     [2] Triangular Approximation Heuristic       │" << endl;
         cout << "│     [3] Cluster Approximation Heuristic          │" << endl;
         cout << "│     [4] Approximation Heuristic Analysis         │" << endl;
         cout << "│     [5] TSP in Real World                        │" << endl;
         cout << "│     [6] Change current dataset                   │" << endl;
         cout << "│     [7] Remove Vertex/Edge                       │" << endl;
+        cout << "│     [8] Candidate Neighbour Lists                │" << endl;
+        cout << "│     [9] Christofides Heuristic                   │" << endl;
         cout << "│     [Q] Exit                                     │" << endl;
         cout << "│" << setw(53) << "│" << endl;
         drawBottom();
@@ -234,7 +222,28 @@ void Menu::drawMenu(int option) {
         cin >> key;
         switch (key) {
             case '1':{
-                drawBacktracking();
+                drawTop();
+                cout << "│" << setw(53) << "│" << endl;
+                cout << "│    Options:                                      │" << endl;
+                cout << "│     [1] Backtracking                             │" << endl;
+                cout << "│     [2] Held-Karp Dynamic Programming            │" << endl;
+                cout << "│     [3] Branch and Bound                         │" << endl;
+                cout << "│     [4] Parallel Backtracking                    │" << endl;
+                drawBottom();
+                char key1;
+                cout << "Choose an option: ";
+                cin >> key1;
+                if (key1 == '1') {
+                    drawBacktracking();
+                } else if (key1 == '2') {
+                    drawHeldKarp();
+                } else if (key1 == '3') {
+                    drawBranchAndBound();
+                } else if (key1 == '4') {
+                    drawParallelBacktracking();
+                } else {
+                    cout << "Invalid option" << endl;
+                }
                 break;
             }
             case '2': {
@@ -257,6 +266,8 @@ void Menu::drawMenu(int option) {
                 cout << "│    Options:                                      │" << endl;
                 cout << "│     [1] Fast Method                              │" << endl;
                 cout << "│     [2] Cost eficient Method                     │" << endl;
+                cout << "│     [3] Chained Lin-Kernighan                    │" << endl;
+                cout << "│     [4] Shortest-Path Metric Closure             │" << endl;
                 drawBottom();
                 char key10;
                 cout << "Choose an option: ";
@@ -271,6 +282,19 @@ void Menu::drawMenu(int option) {
                     cout << "Choose a start vertex: ";
                     cin >> input;
                     drawTspRealWorld2(input);
+                } else if (key10 == '3') {
+                    string input;
+                    double seconds;
+                    cout << "Choose a start vertex: ";
+                    cin >> input;
+                    cout << "Time budget (seconds): ";
+                    cin >> seconds;
+                    drawLinKernighan(input, seconds);
+                } else if (key10 == '4') {
+                    string input;
+                    cout << "Choose a start vertex: ";
+                    cin >> input;
+                    drawMetricClosure(input);
                 } else {
                     cout << "Invalid option" << endl;
                 }
@@ -285,6 +309,30 @@ void Menu::drawMenu(int option) {
                 drawRemoveVertexEdge();
                 break;
             }
+            case '8': {
+                int k;
+                cout << "Neighbours per vertex (k): ";
+                cin >> k;
+                drawCandidateLists(k);
+                break;
+            }
+            case '9': {
+                drawTop();
+                cout << "│" << setw(53) << "│" << endl;
+                cout << "│    Options:                                      │" << endl;
+                cout << "│     [1] Greedy Matching                          │" << endl;
+                cout << "│     [2] Exact Matching (Blossom)                 │" << endl;
+                drawBottom();
+                char key9;
+                cout << "Choose an option: ";
+                cin >> key9;
+                if (key9 == '1' || key9 == '2') {
+                    drawChristofides("0", key9 == '2');
+                } else {
+                    cout << "Invalid option" << endl;
+                }
+                break;
+            }
             case 'Q':
             case 'q': {
                 cout << "Exiting..." << endl;
@@ -372,35 +420,101 @@ void Menu::drawBacktracking() {
 
     chrono::duration<double> duration = end - start;
 
-    if(data_.isTourism()) {
-        cout << "┌─ Backtracking Algorithm  ────────────────────────┐" << endl;
-        cout << "│" << setw(53) << "│" << endl;
-        cout << "│ " << left << setw(12) << "Tour cost: " << right << left << setw(36) << data_.getCost() << right << " │" << endl;
-        cout << "│ " << left << setw(12) << "Tour size: " << right << left << setw(36) << data_.getBestTour().size() << right << " │" << endl;
-        cout << "│ " << left << setw(12) << "Time taken: " << right << left <<  setw(37) << to_string(duration.count()) +  " seconds" << "│" << right << endl;
-        cout << "│" << setw(53) << "│" << endl;
-        for(auto v: data_.getBestTour()) {
-            cout << "│ " << left << "vertex: " << v->getInfo() << " - " << setw(10) << data_.getTourismLabels()[v->getInfo()] << right <<setw(30) << "│"  << endl;
+    drawExactResult("┌─ Backtracking Algorithm  ────────────────────────┐", duration.count());
+}
 
-        }
+
+/**
+ * @brief Draw the results of the Held-Karp dynamic programming algorithm for the Traveling Salesman Problem (TSP).
+ *
+ * This function executes the Held-Karp algorithm, which finds the same optimal tour as the backtracking
+ * algorithm in O(N^2 * 2^N) time instead of O(N!), and displays the results in the same format.
+ */
+void Menu::drawHeldKarp() {
+
+    auto start = chrono::high_resolution_clock::now();
+    data_.heldKarpTSP();
+    auto end = chrono::high_resolution_clock::now();
+
+    chrono::duration<double> duration = end - start;
+
+    drawExactResult("┌─ Held-Karp Algorithm ────────────────────────────┐", duration.count());
+}
+
+
+/**
+ * @brief Draw the results of the branch-and-bound algorithm for the Traveling Salesman Problem (TSP).
+ *
+ * This function executes the branch-and-bound algorithm, which finds the same optimal tour as the
+ * backtracking algorithm while pruning partial tours that cannot improve the best one found so far.
+ */
+void Menu::drawBranchAndBound() {
+
+    auto start = chrono::high_resolution_clock::now();
+    data_.branchAndBoundTSP();
+    auto end = chrono::high_resolution_clock::now();
+
+    chrono::duration<double> duration = end - start;
+
+    drawExactResult("┌─ Branch and Bound Algorithm ─────────────────────┐", duration.count());
+}
+
+
+/**
+ * @brief Draw the results of the parallel backtracking algorithm for the Traveling Salesman Problem (TSP).
+ *
+ * This function runs the same exhaustive search as the backtracking algorithm, split across one
+ * worker thread per hardware thread, and displays the results in the same format.
+ */
+void Menu::drawParallelBacktracking() {
+
+    auto start = chrono::high_resolution_clock::now();
+    data_.parallelBacktrackingTSP(ThreadPool::defaultThreads());
+    auto end = chrono::high_resolution_clock::now();
+
+    chrono::duration<double> duration = end - start;
+
+    drawExactResult("┌─ Parallel Backtracking ──────────────────────────┐", duration.count());
+}
+
+
+/**
+ * @brief Draw the best tour currently stored by the exact algorithms (backtracking and Held-Karp).
+ *
+ * Displays the tour cost, tour size, time taken for computation, and the vertices included in the best tour.
+ * If the problem involves tourism, it also displays the tourism label of each vertex.
+ *
+ * @param title The header line of the box.
+ * @param seconds The time taken by the algorithm.
+ */
+void Menu::drawExactResult(const std::string& title, double seconds) {
+    cout << title << endl;
+    cout << "│" << setw(53) << "│" << endl;
+    if(data_.getBestTour().empty()) {
+        cout << "│" << setw(27)<< "no tour"<< setw(23)<<" " << "│" << endl;
         cout << "│" << setw(53) << right <<"│" << endl;
         cout << "└──────────────────────────────────────────────────┘" << endl;
         waitForEnter();
+        return;
+    }
+    cout << "│ " << left << setw(12) << "Tour cost: " << right << left << setw(36) << data_.getCost() << right << " │" << endl;
+    cout << "│ " << left << setw(12) << "Tour size: " << right << left << setw(36) << data_.getBestTour().size() << right << " │" << endl;
+    cout << "│ " << left << setw(12) << "Time taken: " << right << left <<  setw(37) << to_string(seconds) +  " seconds" << "│" << right << endl;
+    cout << "│" << setw(53) << "│" << endl;
+    if(data_.isTourism()) {
+        for(auto v: data_.getBestTour()) {
+            cout << "│ " << left << "vertex: " << v->getInfo() << " - " << setw(10) << data_.getTourismLabels().at(v->getInfo()) << right <<setw(30) << "│"  << endl;
+
+        }
     } else {
-        cout << "┌─ Backtracking Algorithm  ────────────────────────┐" << endl;
-        cout << "│" << setw(53) << "│" << endl;
-        cout << "│ " << left << setw(12) << "Tour cost: " << right << left << setw(36) << data_.getCost() << right << " │" << endl;
-        cout << "│ " << left << setw(12) << "Tour size: " << right << left << setw(36) << data_.getBestTour().size() << right << " │" << endl;
-        cout << "│ " << left << setw(12) << "Time taken: " << right << left <<  setw(37) << to_string(duration.count()) +  " seconds" << "│" << right << endl;
-        cout << "│" << setw(53) << "│" << endl;
         for(auto v: data_.getBestTour()) {
             cout << "│ " << left << "vertex: " << setw(4) << v->getInfo() << right <<setw(40) << "│"  << endl;
 
         }
-        cout << "│" << setw(53) << right <<"│" << endl;
-        cout << "└──────────────────────────────────────────────────┘" << endl;
-        waitForEnter();
     }
+    cout << "│" << setw(53) << right <<"│" << endl;
+    cout << "└──────────────────────────────────────────────────┘" << endl;
+    waitForEnter();
 }
 
 
@@ -475,8 +589,9 @@ void Menu::drawCluster(string vertex_id) {
 /**
  * @brief Draw the result of the Approximation Heuristic Analysis for the Traveling Salesman Problem (TSP).
  *
- * This function calculates and compares the results of three approximation heuristics
- * (Triangular Approximation, Cluster Approximation, and MST Approximation) for the TSP
+ * This function calculates and compares the results of the approximation heuristics
+ * (Triangular Approximation, Cluster Approximation and, on graphs with coordinates,
+ * Geometric Nearest Neighbour) for the TSP
  * starting from the specified vertex. It draws the results of each heuristic along with
  * the tour cost and the time taken for the calculation.
  *
@@ -508,6 +623,7 @@ void Menu::drawApproximationAnalysis(std::string vertex_id) {
     cout << "│ " << left << setw(12) << "Tour cost: " << right << left << setw(36) << data_.getAproximationTourCost() << right << " │" << endl;
     cout << "│ " << left << setw(12) << "Tour size: " << right << left << setw(36) << data_.getAproximationTour().size() << right << " │" << endl;
     cout << "│ " << left << setw(12) << "Time taken: " << right << left <<  setw(37) << to_string(duration1.count()) +  " seconds" << "│" << right << endl;
+    drawLocalSearch(data_.getAproximationTour());
     cout << "│" << setw(53) << "│" << endl;
 
     auto start2 = chrono::high_resolution_clock::now();
@@ -520,11 +636,48 @@ void Menu::drawApproximationAnalysis(std::string vertex_id) {
     cout << "│ " << left << setw(12) << "Tour cost: " << right << left << setw(36) << data_.getClusterTourCost() << right << " │" << endl;
     cout << "│ " << left << setw(12) << "Tour size: " << right << left << setw(36) << data_.getClusterTour().size() << right << " │" << endl;
     cout << "│ " << left << setw(12) << "Time taken: " << right << left <<  setw(37) << to_string(duration2.count()) +  " seconds" << "│" << right << endl;
+    drawLocalSearch(data_.getClusterTour());
     cout << "│" << setw(53) << "│" << endl;
+
+    auto start3 = chrono::high_resolution_clock::now();
+    data_.geometricNearestNeighbourTSP(vertex_id);
+    auto end3 = chrono::high_resolution_clock::now();
+
+    chrono::duration<double> duration3 = end3 - start3;
+
+    if (!data_.getGeometricTour().empty()) {
+        cout << "│  Geometric Nearest Neighbour :                   │" << endl;
+        cout << "│ " << left << setw(12) << "Tour cost: " << right << left << setw(36) << data_.getGeometricTourCost() << right << " │" << endl;
+        cout << "│ " << left << setw(12) << "Tour size: " << right << left << setw(36) << data_.getGeometricTour().size() << right << " │" << endl;
+        cout << "│ " << left << setw(12) << "Time taken: " << right << left <<  setw(37) << to_string(duration3.count()) +  " seconds" << "│" << right << endl;
+        drawLocalSearch(data_.getGeometricTour());
+        cout << "│" << setw(53) << "│" << endl;
+    }
     cout << "└──────────────────────────────────────────────────┘" << endl;
     waitForEnter();
 }
 
+/**
+ * @brief Draw the cost of a heuristic's tour after improving it with local search (2-opt and Or-opt).
+ *
+ * The tour stored by the heuristic is left unchanged; a copy is improved.
+ *
+ * @param tour The tour found by a heuristic.
+ */
+void Menu::drawLocalSearch(std::vector<Vertex*> tour) {
+    if (tour.size() < 2) {
+        return;
+    }
+    auto start = chrono::high_resolution_clock::now();
+    data_.improveTour(tour);
+    auto end = chrono::high_resolution_clock::now();
+
+    chrono::duration<double> duration = end - start;
+
+    cout << "│ " << left << setw(12) << "Improved: " << right << left << setw(36) << data_.calculateTourCost(tour) << right << " │" << endl;
+    cout << "│ " << left << setw(12) << "Time taken: " << right << left <<  setw(37) << to_string(duration.count()) +  " seconds" << "│" << right << endl;
+}
+
 double Menu::calculate_tour_cost(const std::vector<std::string>& tour) {
     int cost = 0;
     for (size_t i = 0; i < tour.size() - 1; ++i) {
@@ -648,6 +801,139 @@ void Menu::drawTspRealWorld2(std::string vertex_id) {
     waitForEnter();
 }
 
+/**
+ * @brief Draw the results of the chained Lin-Kernighan heuristic starting from a specific vertex.
+ *
+ * Runs Data::linKernighanTSP and shows the time taken, the cost of the tour as tracked by the solver
+ * (the same figure as the last line of the table below it), the number of stops, and the best cost
+ * at each improvement over the time budget (the ten most recent ones, when there are more).
+ *
+ * @param vertex_id The ID of the start vertex.
+ * @param seconds The time budget for the kicks after the first local search, in seconds.
+ */
+void Menu::drawLinKernighan(std::string vertex_id, double seconds) {
+    auto start = chrono::high_resolution_clock::now();
+    std::vector<std::string> tour = data_.linKernighanTSP(vertex_id, seconds);
+    auto end = chrono::high_resolution_clock::now();
+    chrono::duration<double> duration = end - start;
+
+    cout << "┌─ Chained Lin-Kernighan ──────────────────────────┐" << endl;
+    cout << "│                                                  │" << endl;
+    cout << "│ " << left << setw(12) << "Start Node:" << setw(37) << vertex_id << "│" << endl;
+    if (!tour.empty()) {
+        cout << "│ " << left << setw(12) << "Time taken:" << setw(37) << to_string(duration.count()) + " seconds" << "│" << endl;
+        cout << "│ " << left << setw(12) << "Tour Cost:" << setw(37) << fixed << setprecision(2) << data_.getLinKernighanTourCost() << "│" << endl;
+        cout << "│ " << left << setw(12) << "Tour size:" << setw(37) << tour.size() << "│" << endl;
+        cout << "│                                                  │" << endl;
+        cout << "│ Best cost over time:                             │" << endl;
+
+        const auto& progress = data_.getLinKernighanProgress();
+        size_t first = progress.size() > 10 ? progress.size() - 10 : 0;
+        for (size_t i = first; i < progress.size(); i++) {
+            cout << "│   " << right << setw(10) << fixed << setprecision(3) << progress[i].first << " s"
+                 << setw(20) << setprecision(2) << progress[i].second << left << setw(15) << "" << "│" << endl;
+        }
+    } else {
+        cout << "│ No feasible tour exists.                         │" << endl;
+    }
+    cout << "│                                                  │" << endl;
+    cout << "└──────────────────────────────────────────────────┘" << endl;
+    cout << right;
+    waitForEnter();
+}
+
+/**
+ * @brief Draw the results of the metric closure heuristic starting from a specific vertex.
+ *
+ * Shows the cost and size of the tour over the closure and the number of steps of the walk
+ * it stands for in the actual graph.
+ *
+ * @param vertex_id The ID of the start vertex.
+ */
+void Menu::drawMetricClosure(std::string vertex_id) {
+    auto start = chrono::high_resolution_clock::now();
+    std::vector<std::string> tour = data_.metricClosureTSP(vertex_id, ThreadPool::defaultThreads());
+    auto end = chrono::high_resolution_clock::now();
+    chrono::duration<double> duration = end - start;
+
+    cout << "┌─ Shortest-Path Metric Closure ───────────────────┐" << endl;
+    cout << "│                                                  │" << endl;
+    cout << "│ " << left << setw(12) << "Start Node:" << setw(37) << vertex_id << "│" << endl;
+    if (!tour.empty()) {
+        cout << "│ " << left << setw(12) << "Time taken:" << setw(37) << to_string(duration.count()) + " seconds" << "│" << endl;
+        cout << "│ " << left << setw(12) << "Tour Cost:" << setw(37) << fixed << setprecision(2) << data_.getMetricClosureTourCost() << "│" << endl;
+        cout << "│ " << left << setw(12) << "Tour size:" << setw(37) << tour.size() << "│" << endl;
+        cout << "│ " << left << setw(12) << "Walk size:" << setw(37) << data_.expandMetricClosureTour(tour).size() << "│" << endl;
+    } else {
+        cout << "│ No feasible tour exists.                         │" << endl;
+    }
+    cout << "│                                                  │" << endl;
+    cout << "└──────────────────────────────────────────────────┘" << endl;
+    cout << right;
+    waitForEnter();
+}
+
+/**
+ * @brief Draw the results of the Christofides heuristic starting from a specific vertex.
+ *
+ * Shows the tour cost and size, the time taken by every phase and the cost after local search.
+ *
+ * @param vertex_id The ID of the start vertex.
+ * @param exactMatching True for the exact (blossom) matching, false for the greedy one.
+ */
+void Menu::drawChristofides(std::string vertex_id, bool exactMatching) {
+    auto start = chrono::high_resolution_clock::now();
+    data_.christofidesTSP(vertex_id, exactMatching);
+    auto end = chrono::high_resolution_clock::now();
+    chrono::duration<double> duration = end - start;
+
+    cout << "┌─ Christofides Heuristic ─────────────────────────┐" << endl;
+    cout << "│                                                  │" << endl;
+    cout << "│ " << left << setw(12) << "Start Node:" << setw(37) << vertex_id << "│" << endl;
+    if (!data_.getChristofidesTour().empty()) {
+        cout << "│ " << left << setw(12) << "Tour cost: " << setw(37) << data_.getChristofidesTourCost() << "│" << endl;
+        cout << "│ " << left << setw(12) << "Tour size: " << setw(37) << data_.getChristofidesTour().size() << "│" << endl;
+        cout << "│ " << left << setw(12) << "Time taken:" << setw(37) << to_string(duration.count()) + " seconds" << "│" << endl;
+        for (const auto& phase : data_.getChristofidesPhases()) {
+            cout << "│   " << left << setw(20) << phase.first << setw(27) << to_string(phase.second) + " seconds" << "│" << endl;
+        }
+        drawLocalSearch(data_.getChristofidesTour());
+    } else {
+        cout << "│ No tour found.                                   │" << endl;
+    }
+    cout << "│                                                  │" << endl;
+    cout << "└──────────────────────────────────────────────────┘" << endl;
+    cout << right;
+    waitForEnter();
+}
+
+/**
+ * @brief Builds the candidate neighbour lists of the current dataset and shows their size and build time.
+ *
+ * The lists are used by the heuristics run afterwards, until the dataset changes.
+ *
+ * @param k The number of cheapest neighbours kept per vertex.
+ */
+void Menu::drawCandidateLists(int k) {
+    cout << "┌─ Candidate Neighbour Lists ──────────────────────┐" << endl;
+    cout << "│                                                  │" << endl;
+    if (k > 0) {
+        const CandidateLists& lists = data_.buildCandidateLists(k);
+        unsigned vertices = data_.getNetwork().getNumVertex();
+        unsigned total = vertices == 0 ? 0 : lists.end(vertices - 1);
+        cout << "│ " << left << setw(12) << "k:" << setw(37) << k << "│" << endl;
+        cout << "│ " << left << setw(12) << "Candidates:" << setw(37) << total << "│" << endl;
+        cout << "│ " << left << setw(12) << "Longest:" << setw(37) << lists.getMaxLength() << "│" << endl;
+        cout << "│ " << left << setw(12) << "Build time:" << setw(37) << to_string(lists.getBuildTime()) + " seconds" << "│" << endl;
+    } else {
+        cout << "│ k must be positive.                              │" << endl;
+    }
+    cout << "│                                                  │" << endl;
+    cout << "└──────────────────────────────────────────────────┘" << endl;
+    cout << right;
+    waitForEnter();
+}
+
 void Menu::waitForEnter() {
     cin.ignore(numeric_limits<streamsize>::max(), '\n');
     cout << "Press ENTER to continue...";
@@ -0,0 +1,221 @@
+#include "../headerFiles/MetricClosure.h"
+#include "../headerFiles/ShortestPaths.h"
+#include "../headerFiles/ThreadPool.h"
+#include "../headerFiles/MappedFile.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+
+/**
+ * @brief Computes the closure of a set of vertices.
+ *
+ * Every row is one Dijkstra run from a vertex of the set that stops once all the others are settled.
+ * Rows are independent tasks on a thread pool; each worker reuses one ShortestPaths workspace.
+ *
+ * @param graph The frozen graph.
+ * @param vertices The ids of the vertices of the closure, without repetitions.
+ * @param threads The number of worker threads.
+ *
+ * @complexity Time Complexity: O(K (V + E) log V / T), where K is the number of vertices of the closure and T the number of threads.
+ */
+void MetricClosure::build(const CSRGraph& graph, const std::vector<int>& vertices, unsigned threads) {
+    this->vertices = vertices;
+    const int k = vertices.size();
+    auto matrix = std::make_shared<DistanceMatrix>(k, false, std::numeric_limits<double>::infinity());
+    dist = matrix;
+    if (k == 0) {
+        return;
+    }
+
+    ThreadPool pool(std::min<unsigned>(threads, k));
+    std::vector<std::unique_ptr<ShortestPaths>> workspaces(pool.size());
+    for (int i = 0; i < k; i++) {
+        pool.submit([&, i]() {
+            auto& paths = workspaces[pool.currentWorker()];
+            if (paths == nullptr) {
+                paths = std::make_unique<ShortestPaths>(graph);
+            }
+            paths->run({vertices[i]}, vertices);
+            for (int j = 0; j < k; j++) {
+                bool reached = j != i && paths->isSettled(vertices[j]);
+                matrix->set(i, j, reached ? paths->getDist(vertices[j]) : std::numeric_limits<double>::infinity());
+            }
+        });
+    }
+    pool.wait();
+}
+
+/**
+ * Version of the closure file format; bump it whenever the layout below changes.
+ */
+static const uint32_t CLOSURE_VERSION = 2;
+
+static const char CLOSURE_MAGIC[8] = {'P', '2', 'D', 'A', 'C', 'L', 'O', 'S'};
+static const uint32_t CLOSURE_BYTE_ORDER = 0x01020304;
+
+/**
+ * @brief Fixed-size header at the start of a closure file.
+ *
+ * It is followed by the int32 vertex ids (K), padded to 8 bytes, and the K x K double distances, row by row.
+ */
+struct ClosureHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint64_t key;
+    uint64_t numVertices;
+};
+
+/**
+ * @brief Saves the closure to a file.
+ *
+ * The file is written under a temporary name and then renamed, so a crash never leaves a truncated file.
+ *
+ * @param path The file to write.
+ * @param key Identifies the graph the closure belongs to; load only accepts a file with the same key.
+ * @return bool True if the file was written, false otherwise.
+ *
+ * @complexity Time Complexity: O(K^2)
+ */
+bool MetricClosure::save(const std::string& path, uint64_t key) const {
+    ClosureHeader header = {};
+    memcpy(header.magic, CLOSURE_MAGIC, sizeof(header.magic));
+    header.version = CLOSURE_VERSION;
+    header.byteOrder = CLOSURE_BYTE_ORDER;
+    header.key = key;
+    header.numVertices = vertices.size();
+
+    const std::string temporary = path + ".tmp";
+    std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+    if (out.fail()) {
+        return false;
+    }
+    static const char zeros[8] = {};
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    std::vector<int32_t> ids(vertices.begin(), vertices.end());
+    out.write(reinterpret_cast<const char*>(ids.data()), ids.size() * sizeof(int32_t));
+    out.write(zeros, (ids.size() % 2) * sizeof(int32_t));
+    for (int i = 0; i < size(); i++) {
+        out.write(reinterpret_cast<const char*>(dist->row(i)), vertices.size() * sizeof(double));
+    }
+    out.close();
+    std::error_code error;
+    if (!out.fail()) {
+        std::filesystem::rename(temporary, path, error);
+    }
+    if (out.fail() || error) {
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Loads a closure saved by save.
+ *
+ * @param path The file.
+ * @param key The key the file must have been saved with.
+ * @param vertices The vertex ids the closure must be over, in the same order.
+ * @return bool True if the closure was loaded, false if the file is missing, of another graph, subset or
+ *         version, or damaged (the closure is left unchanged in that case).
+ *
+ * @complexity Time Complexity: O(K^2)
+ */
+bool MetricClosure::load(const std::string& path, uint64_t key, const std::vector<int>& vertices) {
+    if (!std::filesystem::exists(path)) {
+        return false;
+    }
+    try {
+        MappedFile file(path);
+        const uint64_t k = vertices.size();
+        const uint64_t idsBytes = (k + k % 2) * sizeof(int32_t);
+        ClosureHeader header;
+        if (file.size() < sizeof(header)) {
+            return false;
+        }
+        memcpy(&header, file.begin(), sizeof(header));
+        if (memcmp(header.magic, CLOSURE_MAGIC, sizeof(header.magic)) != 0 || header.version != CLOSURE_VERSION ||
+            header.byteOrder != CLOSURE_BYTE_ORDER || header.key != key || header.numVertices != k ||
+            file.size() != sizeof(header) + idsBytes + k * k * sizeof(double)) {
+            return false;
+        }
+        const char* ids = file.begin() + sizeof(header);
+        for (uint64_t i = 0; i < k; i++) {
+            int32_t id;
+            memcpy(&id, ids + i * sizeof(int32_t), sizeof(id));
+            if (id != vertices[i]) return false;
+        }
+
+        const char* rows = ids + idsBytes;
+        auto matrix = std::make_shared<DistanceMatrix>(k, false, 0);
+        for (uint64_t i = 0; i < k; i++) {
+            for (uint64_t j = 0; j < k; j++) {
+                double w;
+                memcpy(&w, rows + (i * k + j) * sizeof(double), sizeof(w));
+                matrix->set(i, j, w);
+            }
+        }
+        dist = std::move(matrix);
+        this->vertices = vertices;
+        return true;
+    }
+    catch (const std::ios_base::failure&) {
+        return false;
+    }
+}
+
+/**
+ * @brief Builds a graph on which the complete-graph heuristics can run over the closure.
+ *
+ * The graph has one vertex per vertex of the closure (same name and coordinates, ids in closure order),
+ * edges only to the given number of closest other vertices, so neighbour lists stay short, and the whole
+ * closure as its dense weight matrix, so getEdgeWeight(int, int) answers every pair in O(1). The matrix is
+ * shared with the closure rather than copied.
+ *
+ * @param graph The graph the closure was built from.
+ * @param neighbours The number of edges kept per vertex.
+ * @return Graph The frozen graph.
+ *
+ * @complexity Time Complexity: O(K^2)
+ */
+Graph MetricClosure::toGraph(const Graph& graph, int neighbours) const {
+    Graph result;
+    const int k = size();
+    for (int v : vertices) {
+        Vertex* vertex = graph.getVertex(v);
+        result.addVertex(vertex->getInfo(), vertex->getLong(), vertex->getLat(), vertex->hasCoord());
+    }
+
+    std::vector<EdgeRecord> edges;
+    std::vector<std::pair<double, int>> candidates;
+    for (int i = 0; i < k; i++) {
+        candidates.clear();
+        for (int j = 0; j < k; j++) {
+            if (j != i && dist->get(i, j) != std::numeric_limits<double>::infinity()) {
+                candidates.emplace_back(dist->get(i, j), j);
+            }
+        }
+        size_t keep = std::min<size_t>(neighbours, candidates.size());
+        std::partial_sort(candidates.begin(), candidates.begin() + keep, candidates.end());
+        for (size_t c = 0; c < keep; c++) {
+            edges.push_back({i, candidates[c].second, candidates[c].first});
+        }
+    }
+    result.addEdges(edges, false);
+    result.freeze();
+    result.setDistanceMatrix(dist);
+    return result;
+}
+
+/**
+ * @brief Releases the closure, leaving it empty.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+void MetricClosure::clear() {
+    vertices.clear();
+    dist = std::make_shared<const DistanceMatrix>();
+}
@@ -0,0 +1,390 @@
+#include "../headerFiles/PerfectMatching.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+/**
+ * @brief Constructs the matching problem.
+ *
+ * @param weights The symmetric K x K weights, K even; kept by reference.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+PerfectMatching::PerfectMatching(const DistanceMatrix& weights) : weights(weights) {}
+
+/**
+ * @brief Matches the cheapest pair of unmatched vertices until all are matched.
+ *
+ * @return The mate of every vertex.
+ *
+ * @complexity Time Complexity: O(K^2 log K)
+ */
+std::vector<int> PerfectMatching::greedy() const {
+    const int k = weights.size();
+    std::vector<std::pair<double, std::pair<int, int>>> pairs;
+    pairs.reserve((size_t) k * (k - 1) / 2);
+    for (int i = 0; i < k; i++) {
+        for (int j = i + 1; j < k; j++) {
+            pairs.push_back({weights.get(i, j), {i, j}});
+        }
+    }
+    std::sort(pairs.begin(), pairs.end());
+    std::vector<int> mate(k, -1);
+    for (const auto& p : pairs) {
+        int i = p.second.first, j = p.second.second;
+        if (mate[i] == -1 && mate[j] == -1) {
+            mate[i] = j;
+            mate[j] = i;
+        }
+    }
+    return mate;
+}
+
+/**
+ * @brief Gets the total weight of a matching.
+ *
+ * @param mate The mate of every vertex.
+ * @return The sum of the weights of the matched pairs.
+ *
+ * @complexity Time Complexity: O(K)
+ */
+double PerfectMatching::cost(const std::vector<int>& mate) const {
+    double total = 0;
+    for (int i = 0; i < (int) mate.size(); i++) {
+        if (mate[i] > i) total += weights.get(i, mate[i]);
+    }
+    return total;
+}
+
+/**
+ * @brief Finds a minimum-weight perfect matching with Edmonds' blossom algorithm.
+ *
+ * @return The mate of every vertex.
+ *
+ * @complexity Time Complexity: O(K^3)
+ */
+std::vector<int> PerfectMatching::blossom() {
+    const int k = weights.size();
+    n = nx = k;
+    stride = 2 * k + 1;
+    double largest = 0;
+    for (int i = 0; i < k; i++) {
+        for (int j = 0; j < k; j++) {
+            if (i != j && weights.get(i, j) != std::numeric_limits<double>::infinity()) {
+                largest = std::max(largest, weights.get(i, j));
+            }
+        }
+    }
+    const double scale = largest > 0 ? std::ldexp(1.0, 40) / largest : 1;
+    const int64_t top = (int64_t) 1 << 41;
+
+    g.assign((size_t) stride * stride, {0, 0, 0});
+    flowerFrom.assign((size_t) stride * stride, 0);
+    lab.assign(stride, 0);
+    match.assign(stride, 0);
+    slack.assign(stride, 0);
+    st.assign(stride, 0);
+    pa.assign(stride, 0);
+    S.assign(stride, -1);
+    vis.assign(stride, 0);
+    flower.assign(stride, {});
+    lcaStamp = 0;
+
+    int64_t largestScaled = 0;
+    for (int u = 1; u <= n; u++) {
+        for (int v = 1; v <= n; v++) {
+            edge(u, v) = {u, v, 0};
+            if (u == v) continue;
+            double w = weights.get(u - 1, v - 1);
+            edge(u, v).w = w == std::numeric_limits<double>::infinity() ? 1 : top - std::llround(w * scale);
+            largestScaled = std::max(largestScaled, edge(u, v).w);
+        }
+    }
+    for (int u = 0; u <= n; u++) {
+        st[u] = u;
+    }
+    for (int u = 1; u <= n; u++) {
+        from(u, u) = u;
+        lab[u] = largestScaled;
+    }
+    while (augmentOnce()) {}
+
+    std::vector<int> mate(k, -1);
+    for (int u = 1; u <= n; u++) {
+        if (match[u] != 0) mate[u - 1] = match[u] - 1;
+    }
+    return mate;
+}
+
+/**
+ * @brief Remembers u as the tightest way into x if it is tighter than the current one.
+ */
+void PerfectMatching::updateSlack(int u, int x) {
+    if (slack[x] == 0 || slackOf(edge(u, x)) < slackOf(edge(slack[x], x))) {
+        slack[x] = u;
+    }
+}
+
+/**
+ * @brief Recomputes the tightest way into x from the outer vertices.
+ */
+void PerfectMatching::setSlack(int x) {
+    slack[x] = 0;
+    for (int u = 1; u <= n; u++) {
+        if (edge(u, x).w > 0 && st[u] != x && S[st[u]] == 0) updateSlack(u, x);
+    }
+}
+
+/**
+ * @brief Queues a vertex, or every vertex inside a blossom.
+ */
+void PerfectMatching::push(int x) {
+    if (x <= n) {
+        q.push_back(x);
+        return;
+    }
+    for (int y : flower[x]) {
+        push(y);
+    }
+}
+
+/**
+ * @brief Makes b the outermost blossom of x and of everything inside it.
+ */
+void PerfectMatching::setSt(int x, int b) {
+    st[x] = b;
+    if (x > n) {
+        for (int y : flower[x]) {
+            setSt(y, b);
+        }
+    }
+}
+
+/**
+ * @brief Gets the position of xr in blossom b, reversing the blossom so that the position is even.
+ */
+int PerfectMatching::getPr(int b, int xr) {
+    int pr = std::find(flower[b].begin(), flower[b].end(), xr) - flower[b].begin();
+    if (pr % 2 == 1) {
+        std::reverse(flower[b].begin() + 1, flower[b].end());
+        return (int) flower[b].size() - pr;
+    }
+    return pr;
+}
+
+/**
+ * @brief Matches u through the edge to v, rematching the inside of u when it is a blossom.
+ */
+void PerfectMatching::setMatch(int u, int v) {
+    match[u] = edge(u, v).v;
+    if (u <= n) {
+        return;
+    }
+    BlossomEdge e = edge(u, v);
+    int xr = from(u, e.u), pr = getPr(u, xr);
+    for (int i = 0; i < pr; i++) {
+        setMatch(flower[u][i], flower[u][i ^ 1]);
+    }
+    setMatch(xr, v);
+    std::rotate(flower[u].begin(), flower[u].begin() + pr, flower[u].end());
+}
+
+/**
+ * @brief Flips the alternating path from u back to its root, after matching u to v.
+ */
+void PerfectMatching::augment(int u, int v) {
+    while (true) {
+        int xnv = st[match[u]];
+        setMatch(u, v);
+        if (xnv == 0) return;
+        setMatch(xnv, st[pa[xnv]]);
+        u = st[pa[xnv]];
+        v = xnv;
+    }
+}
+
+/**
+ * @brief Finds the closest common ancestor of u and v in the search forest, or 0 if they are in different trees.
+ */
+int PerfectMatching::getLca(int u, int v) {
+    for (++lcaStamp; u != 0 || v != 0; std::swap(u, v)) {
+        if (u == 0) continue;
+        if (vis[u] == lcaStamp) return u;
+        vis[u] = lcaStamp;
+        u = st[match[u]];
+        if (u != 0) u = st[pa[u]];
+    }
+    return 0;
+}
+
+/**
+ * @brief Shrinks the odd cycle through u, v and their common ancestor lca into a new blossom.
+ */
+void PerfectMatching::addBlossom(int u, int lca, int v) {
+    int b = n + 1;
+    while (b <= nx && st[b] != 0) b++;
+    if (b > nx) nx++;
+    lab[b] = 0;
+    S[b] = 0;
+    match[b] = match[lca];
+    flower[b].clear();
+    flower[b].push_back(lca);
+    for (int x = u, y; x != lca; x = st[pa[y]]) {
+        flower[b].push_back(x);
+        flower[b].push_back(y = st[match[x]]);
+        push(y);
+    }
+    std::reverse(flower[b].begin() + 1, flower[b].end());
+    for (int x = v, y; x != lca; x = st[pa[y]]) {
+        flower[b].push_back(x);
+        flower[b].push_back(y = st[match[x]]);
+        push(y);
+    }
+    setSt(b, b);
+    for (int x = 1; x <= nx; x++) {
+        edge(b, x).w = edge(x, b).w = 0;
+    }
+    for (int x = 1; x <= n; x++) {
+        from(b, x) = 0;
+    }
+    for (int xs : flower[b]) {
+        for (int x = 1; x <= nx; x++) {
+            if (edge(b, x).w == 0 || slackOf(edge(xs, x)) < slackOf(edge(b, x))) {
+                edge(b, x) = edge(xs, x);
+                edge(x, b) = edge(x, xs);
+            }
+        }
+        for (int x = 1; x <= n; x++) {
+            if (from(xs, x) != 0) from(b, x) = xs;
+        }
+    }
+    setSlack(b);
+}
+
+/**
+ * @brief Expands an inner blossom whose dual variable dropped to zero.
+ */
+void PerfectMatching::expandBlossom(int b) {
+    for (int x : flower[b]) {
+        setSt(x, x);
+    }
+    int xr = from(b, edge(b, pa[b]).u), pr = getPr(b, xr);
+    for (int i = 0; i < pr; i += 2) {
+        int xs = flower[b][i], xns = flower[b][i + 1];
+        pa[xs] = edge(xns, xs).u;
+        S[xs] = 1;
+        S[xns] = 0;
+        slack[xs] = 0;
+        setSlack(xns);
+        push(xns);
+    }
+    S[xr] = 1;
+    pa[xr] = pa[b];
+    for (size_t i = pr + 1; i < flower[b].size(); i++) {
+        int xs = flower[b][i];
+        S[xs] = -1;
+        setSlack(xs);
+    }
+    st[b] = 0;
+}
+
+/**
+ * @brief Grows the search forest along a tight edge.
+ *
+ * @return True if the edge closed an augmenting path (which is then applied), false otherwise.
+ */
+bool PerfectMatching::onFoundEdge(const BlossomEdge& e) {
+    int u = st[e.u], v = st[e.v];
+    if (S[v] == -1) {
+        pa[v] = e.u;
+        S[v] = 1;
+        int nu = st[match[v]];
+        slack[v] = slack[nu] = 0;
+        S[nu] = 0;
+        push(nu);
+    }
+    else if (S[v] == 0) {
+        int lca = getLca(u, v);
+        if (lca == 0) {
+            augment(u, v);
+            augment(v, u);
+            return true;
+        }
+        addBlossom(u, lca, v);
+    }
+    return false;
+}
+
+/**
+ * @brief Searches for one augmenting path, adjusting the duals as needed, and applies it.
+ *
+ * @return True if the matching grew, false if it is already maximum.
+ */
+bool PerfectMatching::augmentOnce() {
+    std::fill(S.begin() + 1, S.begin() + nx + 1, -1);
+    std::fill(slack.begin() + 1, slack.begin() + nx + 1, 0);
+    q.clear();
+    for (int x = 1; x <= nx; x++) {
+        if (st[x] == x && match[x] == 0) {
+            pa[x] = 0;
+            S[x] = 0;
+            push(x);
+        }
+    }
+    if (q.empty()) {
+        return false;
+    }
+    while (true) {
+        while (!q.empty()) {
+            int u = q.front();
+            q.pop_front();
+            if (S[st[u]] == 1) continue;
+            for (int v = 1; v <= n; v++) {
+                if (edge(u, v).w > 0 && st[u] != st[v]) {
+                    if (slackOf(edge(u, v)) == 0) {
+                        if (onFoundEdge(edge(u, v))) return true;
+                    }
+                    else {
+                        updateSlack(u, st[v]);
+                    }
+                }
+            }
+        }
+
+        int64_t d = std::numeric_limits<int64_t>::max();
+        for (int b = n + 1; b <= nx; b++) {
+            if (st[b] == b && S[b] == 1) d = std::min(d, lab[b] / 2);
+        }
+        for (int x = 1; x <= nx; x++) {
+            if (st[x] == x && slack[x] != 0) {
+                if (S[x] == -1) d = std::min(d, slackOf(edge(slack[x], x)));
+                else if (S[x] == 0) d = std::min(d, slackOf(edge(slack[x], x)) / 2);
+            }
+        }
+        for (int u = 1; u <= n; u++) {
+            if (S[st[u]] == 0) {
+                if (lab[u] <= d) return false;
+                lab[u] -= d;
+            }
+            else if (S[st[u]] == 1) {
+                lab[u] += d;
+            }
+        }
+        for (int b = n + 1; b <= nx; b++) {
+            if (st[b] == b) {
+                if (S[st[b]] == 0) lab[b] += d * 2;
+                else if (S[st[b]] == 1) lab[b] -= d * 2;
+            }
+        }
+
+        q.clear();
+        for (int x = 1; x <= nx; x++) {
+            if (st[x] == x && slack[x] != 0 && st[slack[x]] != x && slackOf(edge(slack[x], x)) == 0) {
+                if (onFoundEdge(edge(slack[x], x))) return true;
+            }
+        }
+        for (int b = n + 1; b <= nx; b++) {
+            if (st[b] == b && S[b] == 1 && lab[b] == 0) expandBlossom(b);
+        }
+    }
+}
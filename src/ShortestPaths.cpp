@@ -0,0 +1,199 @@
+#include "../headerFiles/ShortestPaths.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief Constructs the workspace for a graph, choosing the heap its weights allow.
+ *
+ * @param graph The frozen graph the queries run on.
+ *
+ * @complexity Time Complexity: O(V + E)
+ */
+ShortestPaths::ShortestPaths(const CSRGraph& graph) : graph(graph), query(0), integral(true) {
+    size_t n = graph.getNumVertex();
+    double longest = 0;
+    for (unsigned e = 0; e < graph.getNumEdges() && integral; e++) {
+        double w = graph.getWeight(e);
+        integral = w >= 0 && w == std::floor(w);
+        longest = std::max(longest, w);
+    }
+    // Every distance is a sum of at most n - 1 weights and must stay exact as a double.
+    integral = integral && longest * (double) n < 9007199254740992.0;
+    stamp.assign(n, 0);
+    targetStamp.assign(n, 0);
+    dist.resize(n);
+    parent.resize(n);
+    origin.resize(n);
+    settled.resize(n);
+    order.reserve(n);
+    if (integral) {
+        radix.reset(n);
+    }
+    else {
+        heap.reset(n);
+    }
+}
+
+/**
+ * @brief Computes the shortest paths from one vertex to every vertex.
+ *
+ * @param source The id of the source vertex.
+ *
+ * @complexity Time Complexity: O((V + E) log V)
+ */
+void ShortestPaths::run(int source) {
+    run(std::vector<int>{source});
+}
+
+/**
+ * @brief Computes the shortest paths from the nearest of several sources.
+ *
+ * Each vertex gets the distance to its closest source, and getOrigin tells which source that is.
+ * With a non-empty target set the search stops as soon as every target is settled; distances of
+ * vertices settled until then are final, the others are only upper bounds (see isSettled).
+ *
+ * @param sources The ids of the source vertices, all at distance 0.
+ * @param targets The ids of the vertices the query is about, or empty to settle every reachable vertex.
+ *
+ * @complexity Time Complexity: O((V' + E') log V'), where V' and E' are the vertices settled and their edges;
+ * O(V' B + E') with integer weights, where B is the number of bits of the longest distance.
+ */
+void ShortestPaths::run(const std::vector<int>& sources, const std::vector<int>& targets) {
+    if (++query == 0) {
+        std::fill(stamp.begin(), stamp.end(), 0);
+        std::fill(targetStamp.begin(), targetStamp.end(), 0);
+        query = 1;
+    }
+    order.clear();
+
+    size_t remaining = 0;
+    for (int t : targets) {
+        if (targetStamp[t] != query) {
+            targetStamp[t] = query;
+            remaining++;
+        }
+    }
+    if (integral) {
+        search<uint64_t>(radix, sources, remaining);
+    }
+    else {
+        search<double>(heap, sources, remaining);
+    }
+}
+
+/**
+ * @brief Runs Dijkstra's algorithm on a given heap (DAryHeap or RadixHeap), keyed by Key.
+ *
+ * @param queue The heap, emptied first.
+ * @param sources The ids of the source vertices, all at distance 0.
+ * @param remaining The number of targets still to settle, or 0 to settle every reachable vertex.
+ *
+ * @complexity Time Complexity: O(V' + E') heap operations.
+ */
+template <class Key, class Heap>
+void ShortestPaths::search(Heap& queue, const std::vector<int>& sources, size_t remaining) {
+    queue.clear();
+    for (int s : sources) {
+        if (isReached(s)) continue;
+        touch(s);
+        dist[s] = 0;
+        origin[s] = s;
+        queue.push(s, 0);
+    }
+
+    while (!queue.empty()) {
+        int v = queue.pop();
+        settled[v] = true;
+        order.push_back(v);
+        if (targetStamp[v] == query && --remaining == 0) {
+            break;
+        }
+        double base = dist[v];
+        for (unsigned e = graph.edgesBegin(v); e < graph.edgesEnd(v); e++) {
+            int w = graph.getTarget(e);
+            double candidate = base + graph.getWeight(e);
+            if (!isReached(w)) {
+                touch(w);
+            }
+            else if (settled[w] || candidate >= dist[w]) {
+                continue;
+            }
+            dist[w] = candidate;
+            parent[w] = v;
+            origin[w] = origin[v];
+            queue.pushOrDecrease(w, static_cast<Key>(candidate));
+        }
+    }
+}
+
+/**
+ * @brief Gets the distance of a vertex from the nearest source in the last query.
+ *
+ * @param v The vertex id.
+ *
+ * @return The distance, or infinity if the vertex was not reached.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+double ShortestPaths::getDist(int v) const {
+    return isReached(v) ? dist[v] : std::numeric_limits<double>::infinity();
+}
+
+/**
+ * @brief Gets the vertex before v on its shortest path.
+ *
+ * @param v The vertex id.
+ *
+ * @return The previous vertex id, or -1 for sources and vertices that were not reached.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+int ShortestPaths::getParent(int v) const {
+    return isReached(v) ? parent[v] : -1;
+}
+
+/**
+ * @brief Gets the source the shortest path to v starts at.
+ *
+ * @param v The vertex id.
+ *
+ * @return The source vertex id, or -1 if the vertex was not reached.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+int ShortestPaths::getOrigin(int v) const {
+    return isReached(v) ? origin[v] : -1;
+}
+
+/**
+ * @brief Rebuilds the shortest path to a vertex.
+ *
+ * @param target The vertex id.
+ *
+ * @return The vertex ids from the source to target, or an empty vector if target was not reached.
+ *
+ * @complexity Time Complexity: O(L), where L is the number of vertices on the path.
+ */
+std::vector<int> ShortestPaths::getPath(int target) const {
+    std::vector<int> path;
+    if (!isReached(target)) {
+        return path;
+    }
+    for (int v = target; v != -1; v = parent[v]) {
+        path.push_back(v);
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+/**
+ * @brief Makes a vertex part of the current query, unsettled and at infinite distance.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+void ShortestPaths::touch(int v) {
+    stamp[v] = query;
+    settled[v] = false;
+    dist[v] = std::numeric_limits<double>::infinity();
+    parent[v] = -1;
+}
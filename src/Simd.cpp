@@ -0,0 +1,97 @@
+#include "../headerFiles/Simd.h"
+#include <limits>
+
+/**
+ * @brief Checks if this build and the CPU support AVX2.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+bool Simd::hasAvx2() {
+#ifdef PROJ2DA_HAS_AVX2
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Checks if this build and the CPU support AVX2 and FMA.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+bool Simd::hasAvx2Fma() {
+#ifdef PROJ2DA_HAS_AVX2
+    static const bool supported = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    return supported;
+#else
+    return false;
+#endif
+}
+
+#ifdef PROJ2DA_HAS_AVX2
+/**
+ * @brief AVX2 version of argMin: the smallest value per lane, then the smallest of the four lanes.
+ */
+__attribute__((target("avx2")))
+static int argMinAvx2(const double* values, int n) {
+    __m256d best = _mm256_set1_pd(std::numeric_limits<double>::infinity());
+    __m256d bestIndex = _mm256_set1_pd(-1);
+    __m256d index = _mm256_setr_pd(0, 1, 2, 3);
+    const __m256d step = _mm256_set1_pd(4);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d v = _mm256_loadu_pd(values + i);
+        __m256d better = _mm256_cmp_pd(v, best, _CMP_LT_OQ);
+        best = _mm256_blendv_pd(best, v, better);
+        bestIndex = _mm256_blendv_pd(bestIndex, index, better);
+        index = _mm256_add_pd(index, step);
+    }
+    double lanes[4], lanesIndex[4];
+    _mm256_storeu_pd(lanes, best);
+    _mm256_storeu_pd(lanesIndex, bestIndex);
+    double bestValue = std::numeric_limits<double>::infinity();
+    int result = -1;
+    for (int lane = 0; lane < 4; lane++) {
+        int candidate = (int) lanesIndex[lane];
+        if (candidate == -1) continue;
+        if (lanes[lane] < bestValue || (lanes[lane] == bestValue && candidate < result)) {
+            bestValue = lanes[lane];
+            result = candidate;
+        }
+    }
+    for (; i < n; i++) {
+        if (values[i] < bestValue) {
+            bestValue = values[i];
+            result = i;
+        }
+    }
+    return result;
+}
+#endif
+
+/**
+ * @brief Finds the first position of the smallest finite value.
+ *
+ * @param values The values.
+ * @param n The number of values.
+ * @return The position, or -1 if every value is infinite (or NaN).
+ *
+ * @complexity Time Complexity: O(N)
+ */
+int Simd::argMin(const double* values, int n) {
+#ifdef PROJ2DA_HAS_AVX2
+    if (hasAvx2()) {
+        return argMinAvx2(values, n);
+    }
+#endif
+    double bestValue = std::numeric_limits<double>::infinity();
+    int result = -1;
+    for (int i = 0; i < n; i++) {
+        if (values[i] < bestValue) {
+            bestValue = values[i];
+            result = i;
+        }
+    }
+    return result;
+}
@@ -0,0 +1,430 @@
+#include "../headerFiles/SpanningTree.h"
+#include "../headerFiles/Simd.h"
+#include "../headerFiles/ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+
+#ifdef PROJ2DA_HAS_AVX2
+/**
+ * @brief AVX2 version of relax: four keys per iteration, parents blended in with the same mask.
+ */
+__attribute__((target("avx2")))
+static void relaxAvx2(const double* row, const double* blocked, double* key, int* parent, int n, int u) {
+    const __m256i lowHalves = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+    const __m128i from = _mm_set1_epi32(u);
+    int v = 0;
+    for (; v + 4 <= n; v += 4) {
+        __m256d w = _mm256_add_pd(_mm256_loadu_pd(row + v), _mm256_load_pd(blocked + v));
+        __m256d k = _mm256_load_pd(key + v);
+        __m256d better = _mm256_cmp_pd(w, k, _CMP_LT_OQ);
+        _mm256_store_pd(key + v, _mm256_blendv_pd(k, w, better));
+        __m128i mask = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(_mm256_castpd_si256(better), lowHalves));
+        __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(parent + v));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(parent + v), _mm_blendv_epi8(p, from, mask));
+    }
+    for (; v < n; v++) {
+        double w = row[v] + blocked[v];
+        if (w < key[v]) {
+            key[v] = w;
+            parent[v] = u;
+        }
+    }
+}
+#endif
+
+/**
+ * @brief Lowers the keys of the vertices reached more cheaply from u, making u their parent.
+ *
+ * @complexity Time Complexity: O(N)
+ */
+static void relax(const double* row, const double* blocked, double* key, int* parent, int n, int u) {
+#ifdef PROJ2DA_HAS_AVX2
+    if (Simd::hasAvx2()) {
+        relaxAvx2(row, blocked, key, parent, n, u);
+        return;
+    }
+#endif
+    for (int v = 0; v < n; v++) {
+        double w = row[v] + blocked[v];
+        if (w < key[v]) {
+            key[v] = w;
+            parent[v] = u;
+        }
+    }
+}
+
+/**
+ * @brief Computes a minimum spanning tree with the array-based Prim's algorithm, for dense graphs.
+ *
+ * No heap: every step scans the keys of all vertices for the closest one and relaxes the keys from its
+ * matrix row (both vectorized when possible), which is O(V^2) in total and beats O(E log V) once E ~ V^2.
+ * Vertices already in the tree are blocked by an infinite penalty, so both loops are branch-free.
+ * Weights are read as weights(u, v) for the edge from the tree vertex u; infinity means no edge.
+ *
+ * @param weights The V x V weights.
+ * @param root The root vertex id.
+ * @param weight Receives the weight of the tree edge of every vertex.
+ * @return The parent of every vertex.
+ *
+ * @complexity Time Complexity: O(V^2)
+ */
+std::vector<int> SpanningTree::densePrim(const DistanceMatrix& weights, int root, std::vector<double>& weight) {
+    const int n = weights.size();
+    const double infinity = std::numeric_limits<double>::infinity();
+    std::vector<int> parent = std::vector<int>(n, -1);
+    weight.assign(n, infinity);
+    std::vector<double, AlignedAllocator<double>> key(n, infinity);
+    std::vector<double, AlignedAllocator<double>> blocked(n, 0);
+    if (n == 0) {
+        return parent;
+    }
+    key[root] = 0;
+    for (int step = 0; step < n; step++) {
+        int u = Simd::argMin(key.data(), n);
+        if (u == -1) {
+            break;
+        }
+        weight[u] = key[u];
+        key[u] = infinity;
+        blocked[u] = infinity;
+        if (weights.isTriangular()) {
+            for (int v = 0; v < n; v++) {
+                double w = weights.get(u, v) + blocked[v];
+                if (w < key[v]) {
+                    key[v] = w;
+                    parent[v] = u;
+                }
+            }
+        }
+        else {
+            relax(weights.row(u), blocked.data(), key.data(), parent.data(), n, u);
+        }
+    }
+    weight[root] = 0;
+    return parent;
+}
+
+/**
+ * @brief Finds the representative of the set of x, halving the path on the way.
+ *
+ * Safe to run concurrently with other finds and with unite: parents only ever move up the tree.
+ *
+ * @complexity Time Complexity: O(log V) amortized.
+ */
+static int findSet(std::vector<std::atomic<int>>& set, int x) {
+    while (true) {
+        int p = set[x].load(std::memory_order_relaxed);
+        if (p == x) return x;
+        int gp = set[p].load(std::memory_order_relaxed);
+        if (gp != p) set[x].compare_exchange_weak(p, gp, std::memory_order_relaxed);
+        x = gp;
+    }
+}
+
+/**
+ * @brief Joins the sets of a and b, hanging the smaller representative under the larger one.
+ *
+ * @return True if they were different sets, false otherwise; of concurrent calls joining the same two
+ *         sets exactly one returns true.
+ *
+ * @complexity Time Complexity: O(log V) amortized.
+ */
+static bool uniteSets(std::vector<std::atomic<int>>& set, int a, int b) {
+    while (true) {
+        a = findSet(set, a);
+        b = findSet(set, b);
+        if (a == b) return false;
+        if (a > b) std::swap(a, b);
+        int expected = a;
+        if (set[a].compare_exchange_strong(expected, b)) return true;
+    }
+}
+
+/**
+ * @brief Computes a minimum spanning tree with Borůvka's algorithm, in parallel, for sparse graphs.
+ *
+ * Every round each component picks its lightest outgoing edge (vertices are split in chunks scanned by
+ * the threads, which offer edges to their component with compare-and-swap) and then all picked edges are
+ * merged through a concurrent union-find. The number of components at least halves per round, and edges
+ * inside a component are dropped from the scans for good. Edges are
+ * ordered by weight, then by their endpoints, so that the picks never form a cycle; edges are taken as
+ * undirected. The forest is then rooted by a breadth-first walk from root. A picked edge that points
+ * from the child to its parent is swapped for its reverse by findTreeEdges.
+ *
+ * @param graph The frozen graph.
+ * @param root The root vertex id.
+ * @param threads The number of worker threads.
+ * @param weight Receives the weight of the tree edge of every vertex.
+ * @param edge Receives the CSR index of the tree edge of every vertex.
+ * @return The parent of every vertex.
+ *
+ * @complexity Time Complexity: O((V + E) log V / T), where T is the number of threads.
+ */
+std::vector<int> SpanningTree::boruvka(const CSRGraph& graph, int root, unsigned threads, std::vector<double>& weight,
+                                       std::vector<unsigned>& edge) {
+    const int n = graph.getNumVertex();
+    std::vector<int> parent = std::vector<int>(n, -1);
+    weight.assign(n, std::numeric_limits<double>::infinity());
+    edge.assign(n, NO_EDGE);
+    if (n == 0) {
+        return parent;
+    }
+
+    // A pick is (source << 32 | edge index) + 1; 0 means none.
+    const uint64_t none = 0;
+    auto source = [](uint64_t pick) { return (int) ((pick - 1) >> 32); };
+    auto edgeOf = [](uint64_t pick) { return (unsigned) ((pick - 1) & 0xffffffffu); };
+    auto lighter = [&graph, &source, &edgeOf](uint64_t a, uint64_t b) {
+        double wa = graph.getWeight(edgeOf(a)), wb = graph.getWeight(edgeOf(b));
+        if (wa != wb) return wa < wb;
+        int ua = source(a), va = graph.getTarget(edgeOf(a)), ub = source(b), vb = graph.getTarget(edgeOf(b));
+        auto ka = std::make_pair(std::min(ua, va), std::max(ua, va));
+        auto kb = std::make_pair(std::min(ub, vb), std::max(ub, vb));
+        return ka != kb ? ka < kb : edgeOf(a) < edgeOf(b);
+    };
+
+    std::vector<std::atomic<int>> set(n);
+    std::vector<std::atomic<uint64_t>> best(n);
+    for (int v = 0; v < n; v++) {
+        set[v].store(v, std::memory_order_relaxed);
+    }
+    // The edges of v still leaving its component are work[edgesBegin(v) .. live[v]); the others are
+    // swapped out once seen, so every round only scans edges that can still be picked.
+    std::vector<unsigned> work(graph.getNumEdges());
+    std::vector<unsigned> live(n);
+    for (int v = 0; v < n; v++) {
+        for (unsigned e = graph.edgesBegin(v); e < graph.edgesEnd(v); e++) {
+            work[e] = e;
+        }
+        live[v] = graph.edgesEnd(v);
+    }
+    ThreadPool pool(std::max(1u, threads));
+    const int chunk = std::max(1024, n / (int) (pool.size() * 8) + 1);
+    const int chunks = (n + chunk - 1) / chunk;
+    std::vector<std::vector<std::pair<int, unsigned>>> picked(chunks);
+    std::vector<std::pair<int, unsigned>> tree;
+
+    while (true) {
+        for (int c = 0; c < chunks; c++) {
+            pool.submit([&, c]() {
+                for (int v = c * chunk; v < std::min(n, (c + 1) * chunk); v++) {
+                    best[v].store(none, std::memory_order_relaxed);
+                }
+            });
+        }
+        pool.wait();
+        for (int c = 0; c < chunks; c++) {
+            pool.submit([&, c]() {
+                for (int v = c * chunk; v < std::min(n, (c + 1) * chunk); v++) {
+                    int component = findSet(set, v);
+                    for (unsigned i = graph.edgesBegin(v); i < live[v]; ) {
+                        unsigned e = work[i];
+                        if (findSet(set, graph.getTarget(e)) == component) {
+                            work[i] = work[--live[v]];
+                            continue;
+                        }
+                        i++;
+                        uint64_t pick = ((uint64_t) v << 32 | e) + 1;
+                        uint64_t current = best[component].load(std::memory_order_relaxed);
+                        while ((current == none || lighter(pick, current)) &&
+                               !best[component].compare_exchange_weak(current, pick, std::memory_order_relaxed)) {}
+                    }
+                }
+            });
+        }
+        pool.wait();
+        for (int c = 0; c < chunks; c++) {
+            pool.submit([&, c]() {
+                picked[c].clear();
+                for (int component = c * chunk; component < std::min(n, (c + 1) * chunk); component++) {
+                    uint64_t pick = best[component].load(std::memory_order_relaxed);
+                    if (pick != none && uniteSets(set, source(pick), graph.getTarget(edgeOf(pick)))) {
+                        picked[c].emplace_back(source(pick), edgeOf(pick));
+                    }
+                }
+            });
+        }
+        pool.wait();
+        for (int c = 0; c < chunks; c++) {
+            pool.submit([&, c]() {
+                for (int v = c * chunk; v < std::min(n, (c + 1) * chunk); v++) {
+                    set[v].store(findSet(set, v), std::memory_order_relaxed);
+                }
+            });
+        }
+        pool.wait();
+        size_t before = tree.size();
+        for (const auto& edges : picked) {
+            tree.insert(tree.end(), edges.begin(), edges.end());
+        }
+        if (tree.size() == before) {
+            break;
+        }
+    }
+
+    // Root the forest: the tree edges (source, edge index) incident to every vertex, in CSR form.
+    std::vector<unsigned> offsets(n + 1, 0);
+    for (const auto& edge : tree) {
+        offsets[edge.first + 1]++;
+        offsets[graph.getTarget(edge.second) + 1]++;
+    }
+    for (int v = 0; v < n; v++) {
+        offsets[v + 1] += offsets[v];
+    }
+    std::vector<unsigned> fill(offsets.begin(), offsets.end() - 1);
+    std::vector<unsigned> incident(2 * tree.size());
+    for (unsigned i = 0; i < tree.size(); i++) {
+        incident[fill[tree[i].first]++] = i;
+        incident[fill[graph.getTarget(tree[i].second)]++] = i;
+    }
+    std::vector<int> queue = {root};
+    weight[root] = 0;
+    for (size_t head = 0; head < queue.size(); head++) {
+        int v = queue[head];
+        for (unsigned i = offsets[v]; i < offsets[v + 1]; i++) {
+            int u = tree[incident[i]].first;
+            unsigned e = tree[incident[i]].second;
+            int other = u == v ? graph.getTarget(e) : u;
+            if (other == root || parent[other] != -1) continue;
+            parent[other] = v;
+            weight[other] = graph.getWeight(e);
+            if (u == v) edge[other] = e;
+            queue.push_back(other);
+        }
+    }
+    findTreeEdges(graph, parent, weight, edge);
+    return parent;
+}
+
+/**
+ * @brief Finds the CSR index of the edge from its parent for every vertex whose entry is still NO_EDGE.
+ *
+ * Among parallel edges the first one with the tree weight is taken, or else the first one. The edges of
+ * every parent are scanned once, however many children it has.
+ *
+ * @param graph The frozen graph.
+ * @param parent The parent of every vertex, -1 for roots.
+ * @param weight The weight of every tree edge.
+ * @param edge The CSR index of the tree edge of every vertex; entries other than NO_EDGE are kept.
+ *
+ * @complexity Time Complexity: O(V + E)
+ */
+void SpanningTree::findTreeEdges(const CSRGraph& graph, const std::vector<int>& parent,
+                                 const std::vector<double>& weight, std::vector<unsigned>& edge) {
+    const int n = parent.size();
+    // 1: the edge is still wanted; 2: one with the tree weight was found.
+    std::vector<uint8_t> state(n, 0);
+    std::vector<bool> scanned(n, false);
+    for (int v = 0; v < n; v++) {
+        if (parent[v] != -1 && edge[v] == NO_EDGE) state[v] = 1;
+    }
+    for (int v = 0; v < n; v++) {
+        if (state[v] != 1 || scanned[parent[v]]) continue;
+        int p = parent[v];
+        scanned[p] = true;
+        for (unsigned e = graph.edgesBegin(p); e < graph.edgesEnd(p); e++) {
+            int child = graph.getTarget(e);
+            if (state[child] != 1 || parent[child] != p) continue;
+            if (edge[child] == NO_EDGE) edge[child] = e;
+            if (graph.getWeight(e) == weight[child]) {
+                edge[child] = e;
+                state[child] = 2;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Builds the child lists of a forest by counting sort on the parents.
+ *
+ * @param parents The parent of every vertex, -1 for roots.
+ *
+ * @complexity Time Complexity: O(V)
+ */
+RootedTree::RootedTree(const std::vector<int>& parents) : parents(parents) {
+    const int n = (int) parents.size();
+    offsets.assign(n + 1, 0);
+    for (int v = 0; v < n; v++) {
+        if (parents[v] != -1) offsets[parents[v] + 1]++;
+    }
+    for (int v = 0; v < n; v++) {
+        offsets[v + 1] += offsets[v];
+    }
+    children.resize(offsets[n]);
+    std::vector<int> next(offsets.begin(), offsets.end() - 1);
+    for (int v = 0; v < n; v++) {
+        if (parents[v] != -1) children[next[parents[v]]++] = v;
+    }
+}
+
+/**
+ * @brief Gets the number of vertices.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+int RootedTree::size() const {
+    return (int) parents.size();
+}
+
+/**
+ * @brief Gets the parent of a vertex, -1 for roots.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+int RootedTree::getParent(int v) const {
+    return parents[v];
+}
+
+/**
+ * @brief Gets the first child of a vertex.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+const int* RootedTree::childrenBegin(int v) const {
+    return children.data() + offsets[v];
+}
+
+/**
+ * @brief Gets one past the last child of a vertex.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+const int* RootedTree::childrenEnd(int v) const {
+    return children.data() + offsets[v + 1];
+}
+
+/**
+ * @brief Lists the vertices in preorder, children in increasing id order.
+ *
+ * The tree of root comes first, then the trees of the other roots in increasing id order, so every
+ * vertex appears exactly once.
+ *
+ * @param root The vertex to start from; it must be a root.
+ * @return The vertex ids in preorder.
+ *
+ * @complexity Time Complexity: O(V)
+ */
+std::vector<int> RootedTree::preorder(int root) const {
+    const int n = size();
+    std::vector<int> order;
+    order.reserve(n);
+    std::vector<int> stack;
+    auto walk = [this, &order, &stack](int from) {
+        stack.push_back(from);
+        while (!stack.empty()) {
+            int v = stack.back();
+            stack.pop_back();
+            order.push_back(v);
+            for (const int* c = childrenEnd(v); c != childrenBegin(v); ) {
+                stack.push_back(*--c);
+            }
+        }
+    };
+    if (root >= 0 && root < n) walk(root);
+    for (int v = 0; v < n; v++) {
+        if (parents[v] == -1 && v != root) walk(v);
+    }
+    return order;
+}
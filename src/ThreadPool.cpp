@@ -0,0 +1,174 @@
+#include "../headerFiles/ThreadPool.h"
+
+/**
+ * The pool the calling thread works for, or nullptr for threads outside of any pool.
+ */
+static thread_local const ThreadPool* workerPool = nullptr;
+
+/**
+ * The index of the calling thread inside workerPool.
+ */
+static thread_local int workerIndex = -1;
+
+/**
+ * @brief Starts the worker threads.
+ *
+ * @param threads The number of workers (at least one is started).
+ *
+ * @complexity Time Complexity: O(T), where T is the number of threads.
+ */
+ThreadPool::ThreadPool(unsigned threads) {
+    if (threads == 0) {
+        threads = 1;
+    }
+    for (unsigned i = 0; i < threads; i++) {
+        workers.push_back(std::make_unique<Worker>());
+    }
+    for (unsigned i = 0; i < threads; i++) {
+        this->threads.emplace_back(&ThreadPool::run, this, i);
+    }
+}
+
+/**
+ * @brief Finishes the queued tasks and joins the worker threads.
+ *
+ * @complexity Time Complexity: O(T) plus the remaining tasks.
+ */
+ThreadPool::~ThreadPool() {
+    {
+        std::unique_lock<std::mutex> guard(stateLock);
+        idle.wait(guard, [this] { return pending == 0; });
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+/**
+ * @brief Gets the number of hardware threads, or 1 if it cannot be determined.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+unsigned ThreadPool::defaultThreads() {
+    unsigned threads = std::thread::hardware_concurrency();
+    return threads == 0 ? 1 : threads;
+}
+
+/**
+ * @brief Gets the index of the calling worker thread.
+ *
+ * @return The index in [0, size()), or -1 if the caller is not one of this pool's workers.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+int ThreadPool::currentWorker() const {
+    return workerPool == this ? workerIndex : -1;
+}
+
+/**
+ * @brief Queues a task.
+ *
+ * @param task The task. If it throws, the first exception is rethrown by wait().
+ *
+ * @complexity Time Complexity: O(1)
+ */
+void ThreadPool::submit(std::function<void()> task) {
+    int self = currentWorker();
+    unsigned index = self >= 0 ? self : nextWorker++ % workers.size();
+    pending++;
+    {
+        std::lock_guard<std::mutex> guard(workers[index]->lock);
+        workers[index]->tasks.push_back(std::move(task));
+    }
+    queued++;
+    {
+        std::lock_guard<std::mutex> guard(stateLock);
+    }
+    wake.notify_one();
+}
+
+/**
+ * @brief Blocks until every submitted task (including tasks submitted by tasks) has finished.
+ *
+ * Must not be called from a worker thread.
+ *
+ * @complexity Time Complexity: O(1) plus the remaining tasks.
+ */
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> guard(stateLock);
+    idle.wait(guard, [this] { return pending == 0; });
+    if (error) {
+        std::exception_ptr e = error;
+        error = nullptr;
+        std::rethrow_exception(e);
+    }
+}
+
+/**
+ * @brief Takes the newest task of a worker's own deque, or else steals the oldest task of another worker.
+ *
+ * @param index The worker.
+ * @param task Output: the task taken.
+ *
+ * @return True if a task was taken, false if every deque was empty.
+ *
+ * @complexity Time Complexity: O(T)
+ */
+bool ThreadPool::take(unsigned index, std::function<void()>& task) {
+    {
+        Worker& own = *workers[index];
+        std::lock_guard<std::mutex> guard(own.lock);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            queued--;
+            return true;
+        }
+    }
+    for (unsigned i = 1; i < workers.size(); i++) {
+        Worker& victim = *workers[(index + i) % workers.size()];
+        std::lock_guard<std::mutex> guard(victim.lock);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            queued--;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Main loop of a worker thread: runs tasks while there are any and sleeps otherwise.
+ *
+ * @param index The worker.
+ */
+void ThreadPool::run(unsigned index) {
+    workerPool = this;
+    workerIndex = index;
+    std::function<void()> task;
+    while (true) {
+        if (take(index, task)) {
+            try {
+                task();
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> guard(stateLock);
+                if (!error) error = std::current_exception();
+            }
+            task = nullptr;
+            if (--pending == 0) {
+                std::lock_guard<std::mutex> guard(stateLock);
+                idle.notify_all();
+            }
+            continue;
+        }
+        std::unique_lock<std::mutex> guard(stateLock);
+        wake.wait(guard, [this] { return stopping || queued > 0; });
+        if (stopping && queued == 0) {
+            return;
+        }
+    }
+}